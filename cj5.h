@@ -69,20 +69,65 @@
 //      - CJ5_ASSERT(e): replace stdc `assert` macro with your own version
 //      - CJ5_MEMSET(dst, value, size): replace 'memset' function with your own
 //      - CJ5_MEMCPY(dst, src, size): replace 'memcpy' function with your own
+//      - CJ5_MEMMOVE(dst, src, size): replace 'memmove' function with your own
 //      - CJ5_TOKEN_HELPERS: add token helper functions (default=ON), you can skip these by definining:
 //                           #define CJ5_TOKEN_HELPERS 0, before including the header
 //      - CJ5_API: API decleration can be override by defining this macro. (default is extern)
 //                 example: #define CJ5_API static
-// 
+//      - CJ5_SIMD: scan strings, comments, primitives and whitespace with SSE2/AVX2/NEON (default=ON)
+//                  set `#define CJ5_SIMD 0` to force the scalar code path
+//      - CJ5_INDEX_MIN_KEYS: objects with at least this many keys get a hash table in `cj5_build_index`
+//                            (default=32)
+//      - CJ5_LARGE: 64-bit positions and token indices (`cj5_int`) for documents larger than 2GB
+//                   (default=OFF), doubles the size of most token fields
+//      - CJ5_MMAP: memory mapped file functions `cj5_file_open`, `cj5_parse_file` (default=ON on
+//                  Linux and other unix systems), set `#define CJ5_MMAP 0` to remove them
+//      - CJ5_PATH_MAX_STEPS: maximum number of keys and indices in a `cj5_path` (default=16)
+//      - CJ5_SCHEMA_MAX_FIELDS: maximum number of fields in a `cj5_schema` (default=256)
+//      - CJ5_VALIDATE_MAX_DEPTH: nesting levels that `cj5_validate` can track, keys count as a
+//                                level (default=4096)
+//      - CJ5_STATS: fill `cj5_result.stats` with byte, token and nesting counts (default=OFF)
+//      - CJ5_STATS_CLOCK(): with CJ5_STATS, a counter like `__rdtsc()` for per-phase cycle counts,
+//                           not measured if it's not defined
+//
 #pragma once
 
 #include <stdbool.h>    // bool
 #include <stdint.h>     // uint32_t, int64_t, etc.
+#include <stddef.h>     // size_t
 
 #ifndef CJ5_TOKEN_HELPERS
 #    define CJ5_TOKEN_HELPERS 1
 #endif
 
+#ifndef CJ5_LARGE
+#    define CJ5_LARGE 0
+#endif
+
+#ifndef CJ5_MMAP
+#    if defined(__unix__) || defined(__APPLE__)
+#        define CJ5_MMAP 1
+#    else
+#        define CJ5_MMAP 0
+#    endif
+#endif
+
+#ifndef CJ5_PATH_MAX_STEPS
+#    define CJ5_PATH_MAX_STEPS 16
+#endif
+
+#ifndef CJ5_SCHEMA_MAX_FIELDS
+#    define CJ5_SCHEMA_MAX_FIELDS 256
+#endif
+
+#ifndef CJ5_VALIDATE_MAX_DEPTH
+#    define CJ5_VALIDATE_MAX_DEPTH 4096
+#endif
+
+#ifndef CJ5_STATS
+#    define CJ5_STATS 0
+#endif
+
 #ifndef CJ5_API
 #    ifdef __cplusplus
 #        define CJ5_API extern "C"
@@ -95,6 +140,13 @@
 #    define CJ5_SKIP_ASAN
 #endif
 
+// positions and lengths in the document, and token indices
+#if CJ5_LARGE
+typedef int64_t cj5_int;
+#else
+typedef int cj5_int;
+#endif
+
 typedef enum cj5_token_type {
     CJ5_TOKEN_OBJECT = 0,
     CJ5_TOKEN_ARRAY,
@@ -117,7 +169,9 @@ typedef enum cj5_error_code {
     CJ5_ERROR_NONE = 0,
     CJ5_ERROR_INVALID,       // invalid character/syntax
     CJ5_ERROR_INCOMPLETE,    // incomplete json string
-    CJ5_ERROR_OVERFLOW       // token buffer overflow, need more tokens (see cj5_result.num_tokens)
+    CJ5_ERROR_OVERFLOW,      // token buffer overflow, need more tokens (see cj5_result.num_tokens)
+    CJ5_ERROR_FILE,          // file can't be opened or mapped (see cj5_parse_file)
+    CJ5_ERROR_CACHE          // token cache doesn't match the document or the build (see cj5_load_tokens)
 } cj5_error_code;
 
 typedef struct cj5_token {
@@ -126,59 +180,503 @@ typedef struct cj5_token {
         cj5_token_number_type num_type;
         uint32_t key_hash;
     };
-    int key_start;
-    int key_end;
-    int start;
-    int end;
-    int size;
-    int parent_id;      // = -1 if there is no parent
+    cj5_int key_start;
+    cj5_int key_end;
+    cj5_int start;
+    cj5_int end;
+    cj5_int size;
+    cj5_int parent_id;      // = -1 if there is no parent
+    cj5_int next_id;        // index of the first token after this token and all of its children (next sibling)
+    bool escaped;       // STRING token contains escape sequences, see `cj5_unescape`
 } cj5_token;
 
+// 16 byte token, see `cj5_compact`. key hashes are kept in a separate array (`cj5_result.key_hashes`)
+// and `size`/`parent_id` are not stored, `cj5_get_token` recovers them
+typedef struct cj5_compact_token {
+    uint32_t start;
+    uint32_t len;
+    uint32_t next;      // next_id - id
+    uint32_t info;      // type:3, num_type:2, escaped:1, key:1, id - parent_id:25 (0 = no parent)
+} cj5_compact_token;
+
+// bits of `cj5_compact_token.info`
+#define CJ5_COMPACT_TYPE_MASK 0x7
+#define CJ5_COMPACT_NUM_TYPE_SHIFT 3
+#define CJ5_COMPACT_ESCAPED 0x20
+#define CJ5_COMPACT_KEY 0x40
+#define CJ5_COMPACT_PARENT_SHIFT 7
+#define CJ5_COMPACT_PARENT_FAR 0x1ffffff    // parent is further away, search for it
+
+// type and next_id of a compact token, for inlined loops over either layout (see `cj5_get_type`)
+#define CJ5_COMPACT_TYPE(_c) ((cj5_token_type)((_c)->info & CJ5_COMPACT_TYPE_MASK))
+#define CJ5_COMPACT_NEXT_ID(_c, _id) ((_id) + (cj5_int)(_c)->next)
+
+#if CJ5_STATS
+// what the parser spent its time on, see CJ5_STATS. filled by `cj5_parse`, `cj5_parse_realloc` and
+// `cj5_parser_feed`/`cj5_parser_finish`, counted up to the error if there is one.
+// the byte counts don't include brackets, ':', ',' and line breaks that end a comment
+typedef struct cj5_stats {
+    cj5_int bytes_whitespace;
+    cj5_int bytes_comments;
+    cj5_int bytes_strings;      // with the quotes, and keys without quotes
+    cj5_int bytes_numbers;
+    cj5_int bytes_literals;     // true, false, null
+    cj5_int num_tokens[6];      // by `cj5_token_type`, also the ones that didn't fit
+    cj5_int max_depth;          // deepest nesting of objects and arrays
+    cj5_int max_close_walk;     // most tokens a '}' or ']' visits to find the container it closes
+    cj5_int num_grows;          // times the token array was grown by `cj5_parse_realloc`
+    uint64_t cycles_strings;    // per-phase CJ5_STATS_CLOCK() counts, 0 if it's not defined
+    uint64_t cycles_primitives;
+    uint64_t cycles_comments;
+    uint64_t cycles_brackets;
+    uint64_t cycles_total;
+} cj5_stats;
+#endif
+
 typedef struct cj5_result {
     cj5_error_code error;
-    int error_line;
-    int error_col;
-    int num_tokens;
-    const cj5_token* tokens;
+    cj5_int error_line;
+    cj5_int error_col;
+    cj5_int num_tokens;
+    const cj5_token* tokens;    // NULL after `cj5_compact`
     const char* json5;
+    const void* index;    // optional key lookup index, see `cj5_build_index`
+    const cj5_compact_token* compact;    // compact layout, see `cj5_compact`
+    const uint32_t* key_hashes;          // key hash of compact token i (0 for non-key tokens)
+#if CJ5_STATS
+    cj5_stats stats;
+#endif
 } cj5_result;
 
-CJ5_API cj5_result cj5_parse(const char* json5, int len, cj5_token* tokens, int max_tokens);
+// realloc style callback for growing the token array, see `cj5_parse_realloc`
+// return NULL if the memory can't be grown, the old memory should remain valid in that case
+typedef void* (cj5_realloc_fn)(void* ptr, size_t size, void* user);
+
+// parser state, exposed for parsing a document in multiple steps while the data arrives
+typedef struct cj5_parser {
+    cj5_int pos;
+    cj5_int next_id;
+    cj5_int super_id;
+    cj5_int line;
+    cj5_int num_tokens;     // number of tokens needed so far, can be more than max_tokens
+    cj5_int max_tokens;
+    cj5_token* tokens;
+    cj5_realloc_fn* realloc_fn;
+    void* realloc_user;
+    int pending;        // internal: string/primitive/comment was cut at the end of data
+    bool can_comment;
+    struct cj5__chunk* chunk;    // internal: parallel parsing
+#if CJ5_STATS
+    cj5_int depth;      // internal: nesting of the current position
+#endif
+    cj5_result result;
+} cj5_parser;
+
+// parallel parsing: runs `task(data, i)` for i = [0, count) and returns when all of them are done
+typedef void (cj5_task_fn)(void* data, int index);
+typedef void (cj5_dispatch_fn)(cj5_task_fn* task, void* data, int count, void* user);
+
+typedef struct cj5_parallel_desc {
+    int num_chunks;                 // number of pieces that the document is split into
+    int min_chunk_size;             // smaller documents are parsed serially (default = 1MB)
+    cj5_dispatch_fn* dispatch_fn;   // runs the tasks, typically on a thread pool
+    void* dispatch_user;
+    cj5_realloc_fn* realloc_fn;     // temp memory, called from worker threads, size = 0 frees `ptr`
+    void* realloc_user;
+} cj5_parallel_desc;
+
+// newline delimited records (NDJSON), see `cj5_parse_records`
+typedef struct cj5_record {
+    cj5_int token_begin;        // index of the record's first token in the shared token array
+    cj5_int token_count;        // token ids of the record are relative to `token_begin`
+    cj5_int start;              // line of the record in the document, without the new line
+    cj5_int end;
+    cj5_error_code error;   // tokens of invalid records are not kept (token_count = 0)
+} cj5_record;
+
+typedef struct cj5_records_result {
+    cj5_error_code error;   // CJ5_ERROR_OVERFLOW if the arrays are too small, or the first record error
+    cj5_int num_records;        // can be more than max_records (CJ5_ERROR_OVERFLOW)
+    cj5_int num_tokens;         // can be more than max_tokens (CJ5_ERROR_OVERFLOW)
+    cj5_int num_invalid;        // number of records with errors
+    const cj5_record* records;
+    const cj5_token* tokens;
+    const char* json5;
+} cj5_records_result;
+
+// an edit of a parsed document: bytes [start, end) of the old document were replaced with `new_len`
+// bytes, see `cj5_parse_edit`
+typedef struct cj5_edit {
+    cj5_int start;
+    cj5_int end;
+    cj5_int new_len;
+} cj5_edit;
+
+// read-only memory mapped file, see `cj5_file_open`
+typedef struct cj5_file {
+    const char* data;
+    cj5_int size;
+} cj5_file;
+
+typedef struct cj5_writer {
+    char* buf;
+    cj5_int len;            // bytes needed so far, can be more than `capacity` (CJ5_ERROR_OVERFLOW)
+    cj5_int capacity;
+    cj5_realloc_fn* realloc_fn;
+    void* realloc_user;
+    int indent;         // spaces per nesting level, 0 = compact output
+    bool json5;
+    int depth;          // internal
+    bool first;         // internal: no values in the current container yet
+    bool after_key;     // internal
+    cj5_error_code error;
+} cj5_writer;
+
+CJ5_API cj5_result cj5_parse(const char* json5, cj5_int len, cj5_token* tokens, cj5_int max_tokens);
+
+// same as `cj5_parse`, but grows the token array with `realloc_fn` instead of returning
+// CJ5_ERROR_OVERFLOW, so the document is parsed only once.
+// `tokens` can be NULL or memory that is allocated by `realloc_fn` (not on stack!).
+// result's `tokens` is owned by the caller and should be freed with the matching allocator.
+// if `realloc_fn` fails, it falls back to counting the tokens and returns CJ5_ERROR_OVERFLOW
+CJ5_API cj5_result cj5_parse_realloc(const char* json5, cj5_int len, cj5_token* tokens,
+                                     cj5_int max_tokens, cj5_realloc_fn* realloc_fn, void* user);
+
+// checks a document without a token array. `error`, `error_line` and `error_col` are the same as
+// `cj5_parse` with enough tokens, and `num_tokens` is the number of tokens that it needs.
+// the nesting is kept in bit stacks, documents nested deeper than CJ5_VALIDATE_MAX_DEPTH return
+// CJ5_ERROR_OVERFLOW
+CJ5_API cj5_result cj5_validate(const char* json5, cj5_int len);
+
+// returns the number of tokens that `cj5_parse` needs for the document, to allocate them before the
+// parse. it only follows quotes, brackets, separators and comments, values are skipped without
+// looking at them, so the count is exact for documents that `cj5_parse` accepts (`cj5_validate`).
+// optional: `max_depth` is the deepest nesting of objects and arrays, `string_bytes` the length of
+// all strings and keys in the document, without quotes and with escape sequences as they are
+CJ5_API cj5_int cj5_count_tokens(const char* json5, cj5_int len, cj5_int* max_depth,
+                                 cj5_int* string_bytes);
+
+// incremental parse of an edited document: `json5` is the new document and `prev` is the result of
+// the old one, which must use `tokens` (full layout) and is updated in place. only the smallest
+// object or array around the edit is parsed again, then its tokens are spliced in and the tokens
+// after it are moved. falls back to parsing the whole document if the edit changes anything outside
+// of that container. the tokens of `prev` are overwritten in both cases, and the index is dropped
+CJ5_API cj5_result cj5_parse_edit(const char* json5, cj5_int len, cj5_token* tokens,
+                                  cj5_int max_tokens, const cj5_result* prev,
+                                  const cj5_edit* edit);
+
+// same as `cj5_parse`, but splits the document into chunks that are tokenized in parallel with
+// `desc->dispatch_fn`. chunks start at new lines or commas, and are assumed to start outside of
+// strings and comments. the guess is checked when the chunks are stitched together, and wrong ones
+// are parsed again. the result is the same as `cj5_parse`, errors are reported by a serial parse
+CJ5_API cj5_result cj5_parse_parallel(const char* json5, cj5_int len, cj5_token* tokens,
+                                      cj5_int max_tokens, const cj5_parallel_desc* desc);
+
+// parses a document where every line is a separate value into one token array, and fills `records`
+// with the token and byte range of each line. blank lines (and comment-only lines) are skipped.
+// an invalid record doesn't stop the parse, see `cj5_record.error` and `num_invalid`.
+// like in `cj5_parse`, a number/bool/null on the last line needs a line break after it to be complete.
+// like `cj5_parse`, if the arrays are full it keeps counting the tokens and records that are needed.
+// use `cj5_get_record` to use the helper functions on a record
+CJ5_API cj5_records_result cj5_parse_records(const char* json5, cj5_int len, cj5_token* tokens,
+                                             cj5_int max_tokens, cj5_record* records,
+                                             cj5_int max_records);
+
+// same as `cj5_parse_records`, but splits the document at line boundaries and parses the pieces with
+// `desc->dispatch_fn`. the result is the same as `cj5_parse_records`, if the arrays are too small
+// the document is parsed serially to report the overflow
+CJ5_API cj5_records_result cj5_parse_records_parallel(const char* json5, cj5_int len,
+                                                      cj5_token* tokens, cj5_int max_tokens,
+                                                      cj5_record* records, cj5_int max_records,
+                                                      const cj5_parallel_desc* desc);
+CJ5_API cj5_result cj5_get_record(const cj5_records_result* rs, cj5_int index);
+
+#if CJ5_MMAP
+// maps a file into memory instead of reading it, so there is no copy and the pages are loaded by the
+// OS while the parser reads them sequentially. the results point into `file->data`, so the file
+// should stay open as long as they are used. files larger than 2GB need CJ5_LARGE.
+// `cj5_parse_file` opens `file` and parses it, returns CJ5_ERROR_FILE if it can't be opened, the file
+// is still open on parse errors (and needs `cj5_file_close`) so the result can be inspected
+CJ5_API bool cj5_file_open(cj5_file* file, const char* filepath);
+CJ5_API void cj5_file_close(cj5_file* file);
+CJ5_API cj5_result cj5_parse_file(cj5_file* file, const char* filepath, cj5_token* tokens,
+                                  cj5_int max_tokens);
+#endif
+
+// streaming: `json5` always points to the beginning of the document and `len` is the number of bytes
+// received so far, so the buffer can grow (or move) between the calls, but should keep its contents.
+// strings, numbers and comments that are cut at the end of data are continued in the next call.
+// `cj5_parser_feed` returns the error so far, `cj5_parser_finish` parses the rest of the document
+// and returns the same result as `cj5_parse`
+CJ5_API void cj5_parser_init(cj5_parser* parser, cj5_token* tokens, cj5_int max_tokens);
+CJ5_API cj5_error_code cj5_parser_feed(cj5_parser* parser, const char* json5, cj5_int len);
+CJ5_API cj5_result cj5_parser_finish(cj5_parser* parser, const char* json5, cj5_int len);
+CJ5_API void cj5_parser_set_realloc(cj5_parser* parser, cj5_realloc_fn* realloc_fn, void* user);
+
+// decodes escape sequences of string `src` (without quotes) into `dst`, \uXXXX is written as UTF-8.
+// decoded string is never longer than the source, so `dst` can be the same as `src` to decode a
+// mutable document in place. writes at most `max_dst` bytes without null-terminator, returns the
+// number of bytes written
+CJ5_API cj5_int cj5_unescape(char* dst, cj5_int max_dst, const char* src, cj5_int len);
+
+// converts the tokens of a parsed document to the compact layout (16 bytes per token, plus 4 bytes
+// per token for the key hashes), the token helpers work the same on both layouts.
+// returns the number of bytes needed. if `mem` is NULL or `mem_size` is smaller than that, nothing
+// is converted. `mem` can be the token array itself to convert in place. returns -1 if positions
+// don't fit in 32 bits (CJ5_LARGE). token ids stay the same, so an index can be built before or after
+CJ5_API cj5_int cj5_compact(cj5_result* r, void* mem, cj5_int mem_size);
+// reads token `id` from either layout
+CJ5_API cj5_token cj5_get_token(const cj5_result* r, cj5_int id);
+CJ5_API cj5_token_type cj5_get_type(const cj5_result* r, cj5_int id);
+// index of the next sibling, the token after `id` and all of its children
+CJ5_API cj5_int cj5_get_next(const cj5_result* r, cj5_int id);
+
+// token cache: saves the tokens of a parsed document (either layout) into a binary blob that is
+// tagged with the length and a 64-bit hash of the document, so the next run can load the tokens
+// instead of parsing the document again. `len` is the size of the document that was parsed.
+// `cj5_save_tokens` returns the number of bytes needed and writes nothing if `mem` is NULL or
+// smaller than that, returns -1 for results with errors.
+// the index is not saved, build it again after loading (see `cj5_build_index`)
+CJ5_API cj5_int cj5_save_tokens(const cj5_result* r, cj5_int len, void* mem, cj5_int mem_size);
+// returns a result with the tokens of a saved blob, without copying them, so the blob (8 byte
+// aligned, like a memory mapped file) should stay valid as long as the result is used.
+// `json5` is the document that the blob is checked against, returns CJ5_ERROR_CACHE if it was saved
+// for another document, version or token layout (CJ5_LARGE), or the blob is damaged. `verify`
+// hashes the document and the tokens to detect changes, without it only the sizes are checked,
+// for when the caller knows that the document hasn't changed (file timestamps, etc.)
+CJ5_API cj5_result cj5_load_tokens(const void* blob, cj5_int blob_size, const char* json5,
+                                   cj5_int len, bool verify);
+
+// writer: appends JSON (or JSON5) text to `buf`. like the parser, if `buf` is full the writer keeps
+// counting the bytes and sets CJ5_ERROR_OVERFLOW, so after `cj5_writer_finish` `len` is the buffer
+// size that is needed, including the null terminator.
+// use `cj5_writer_set_realloc` to grow the buffer instead (`buf` must be allocated by `realloc_fn`
+// then, and is owned by the caller).
+// set `indent` to the number of spaces per level for pretty output, and `json5` to write identifier
+// keys without quotes and NaN/Infinity numbers (written as null otherwise), after `cj5_writer_init`
+CJ5_API void cj5_writer_init(cj5_writer* w, char* buf, cj5_int capacity);
+CJ5_API void cj5_writer_set_realloc(cj5_writer* w, cj5_realloc_fn* realloc_fn, void* user);
+// null-terminates the output and returns the error. on success `len` is the length of the text
+// (without the terminator), on CJ5_ERROR_OVERFLOW it is the capacity needed to write it all
+CJ5_API cj5_error_code cj5_writer_finish(cj5_writer* w);
+CJ5_API void cj5_write_begin_object(cj5_writer* w);
+CJ5_API void cj5_write_end_object(cj5_writer* w);
+CJ5_API void cj5_write_begin_array(cj5_writer* w);
+CJ5_API void cj5_write_end_array(cj5_writer* w);
+// `len` = -1 for null-terminated strings
+CJ5_API void cj5_write_key(cj5_writer* w, const char* key, cj5_int len);
+CJ5_API void cj5_write_string(cj5_writer* w, const char* str, cj5_int len);
+CJ5_API void cj5_write_double(cj5_writer* w, double value);
+CJ5_API void cj5_write_int64(cj5_writer* w, int64_t value);
+CJ5_API void cj5_write_uint64(cj5_writer* w, uint64_t value);
+CJ5_API void cj5_write_bool(cj5_writer* w, bool value);
+CJ5_API void cj5_write_null(cj5_writer* w);
 
 // token helpers
 #if CJ5_TOKEN_HELPERS
-CJ5_API int cj5_seek(cj5_result* r, int parent_id, const char* key);
-CJ5_API int cj5_seek_hash(cj5_result* r, int parent_id, const uint32_t key_hash);
-CJ5_API int cj5_seek_recursive(cj5_result* r, int parent_id, const char* key);
-CJ5_API const char* cj5_get_string(cj5_result* r, int id, char* str, int max_str);
-CJ5_API double cj5_get_double(cj5_result* r, int id);
-CJ5_API float cj5_get_float(cj5_result* r, int id);
-CJ5_API int cj5_get_int(cj5_result* r, int id);
-CJ5_API uint32_t cj5_get_uint(cj5_result* r, int id);
-CJ5_API uint64_t cj5_get_uint64(cj5_result* r, int id);
-CJ5_API int64_t cj5_get_int64(cj5_result* r, int id);
-CJ5_API bool cj5_get_bool(cj5_result* r, int id);
-CJ5_API double cj5_seekget_double(cj5_result* r, int parent_id, const char* key, double def_val);
-CJ5_API float cj5_seekget_float(cj5_result* r, int parent_id, const char* key, float def_val);
-CJ5_API int cj5_seekget_array_int16(cj5_result* r, int parent_id, const char* key, int16_t* values, int max_values);
-CJ5_API int cj5_seekget_array_uint16(cj5_result* r, int parent_id, const char* key, uint16_t* values, int max_values);
-CJ5_API int cj5_seekget_int(cj5_result* r, int parent_id, const char* key, int def_val);
-CJ5_API uint32_t cj5_seekget_uint(cj5_result* r, int parent_id, const char* key, uint32_t def_val);
-CJ5_API uint64_t cj5_seekget_uint64(cj5_result* r, int parent_id, const char* key, uint64_t def_val);
-CJ5_API int64_t cj5_seekget_int64(cj5_result* r, int parent_id, const char* key, int64_t def_val);
-CJ5_API bool cj5_seekget_bool(cj5_result* r, int parent_id, const char* key, bool def_val);
-CJ5_API const char* cj5_seekget_string(cj5_result* r, int parent_id, const char* key, char* str, int max_str, const char* def_val);
-
-CJ5_API int cj5_seekget_array_double(cj5_result* r, int parent_id, const char* key, double* values, int max_values);
-CJ5_API int cj5_seekget_array_float(cj5_result* r, int parent_id, const char* key, float* values, int max_values);
-CJ5_API int cj5_seekget_array_int(cj5_result* r, int parent_id, const char* key, int* values, int max_values);
-CJ5_API int cj5_seekget_array_uint(cj5_result* r, int parent_id, const char* key, uint32_t* values, int max_values);
-CJ5_API int cj5_seekget_array_uint64(cj5_result* r, int parent_id, const char* key, uint64_t* values, int max_values);
-CJ5_API int cj5_seekget_array_int64(cj5_result* r, int parent_id, const char* key, int64_t* values, int max_values);
-CJ5_API int cj5_seekget_array_bool(cj5_result* r, int parent_id, const char* key, bool* values, int max_values);
-CJ5_API int cj5_seekget_array_string(cj5_result* r, int parent_id, const char* key, char** strs, int max_str, int max_values);
-CJ5_API int cj5_get_array_elem(cj5_result* r, int id, int index);
-CJ5_API int cj5_get_array_elem_incremental(cj5_result* r, int id, int index, int prev_elem);
+// value type for `cj5_get_array_numbers`
+typedef enum cj5_array_type {
+    CJ5_ARRAY_DOUBLE = 0,
+    CJ5_ARRAY_FLOAT,
+    CJ5_ARRAY_INT16,
+    CJ5_ARRAY_UINT16,
+    CJ5_ARRAY_INT,
+    CJ5_ARRAY_UINT,
+    CJ5_ARRAY_INT64,
+    CJ5_ARRAY_UINT64
+} cj5_array_type;
+
+// compiled path query, see `cj5_compile_path`
+typedef struct cj5_path_step {
+    uint32_t key_hash;
+    cj5_int index;      // array index, -1 for object keys
+} cj5_path_step;
+
+typedef struct cj5_path {
+    int num_steps;
+    cj5_path_step steps[CJ5_PATH_MAX_STEPS];
+} cj5_path;
+
+// struct member type for `cj5_field`
+typedef enum cj5_field_type {
+    CJ5_FIELD_DOUBLE = 0,   // default: def.d
+    CJ5_FIELD_FLOAT,        // def.d
+    CJ5_FIELD_INT,          // def.i, values are clamped like `cj5_get_int`
+    CJ5_FIELD_UINT,         // def.u
+    CJ5_FIELD_INT64,        // def.i
+    CJ5_FIELD_UINT64,       // def.u
+    CJ5_FIELD_BOOL,         // def.b
+    CJ5_FIELD_STRING,       // char array of `size` bytes, decoded and null-terminated. def.s (NULL = "")
+    CJ5_FIELD_OBJECT,       // nested struct, described by `schema`
+    CJ5_FIELD_TOKEN         // cj5_int token id of any value (arrays etc.), -1 if it's missing
+} cj5_field_type;
+
+
+// describes a struct member, example:
+//      { "width", CJ5_FIELD_INT, offsetof(settings, width), 0, { .i = 640 }, NULL }
+typedef struct cj5_field {
+    const char* key;
+    cj5_field_type type;
+    int offset;         // offsetof the member
+    int size;           // CJ5_FIELD_STRING: size of the char array
+    union {
+        double d;
+        int64_t i;
+        uint64_t u;
+        bool b;
+        const char* s;
+    } def;
+    const struct cj5_schema* schema;    // CJ5_FIELD_OBJECT
+} cj5_field;
+
+typedef struct cj5_schema {
+    const cj5_field* fields;
+    int num_fields;
+    int mask;               // number of slots - 1
+    const void* slots;      // internal: key hash table
+} cj5_schema;
+
+// on-demand access to a document without tokens, see `cj5_cursor_init`
+typedef struct cj5_cursor {
+    const char* json5;
+    cj5_int len;
+    cj5_int pos;            // first character of the current value
+    cj5_int key_start;      // key of the value if it's an object member (-1 otherwise), in `json5`
+    cj5_int key_end;        // without quotes, escape sequences are not decoded
+    int depth;              // 0 for the root value
+    cj5_error_code error;   // first error, all functions fail after it
+    cj5_int error_pos;
+} cj5_cursor;
+
+CJ5_API cj5_int cj5_seek(cj5_result* r, cj5_int parent_id, const char* key);
+CJ5_API cj5_int cj5_seek_hash(cj5_result* r, cj5_int parent_id, const uint32_t key_hash);
+CJ5_API cj5_int cj5_seek_recursive(cj5_result* r, cj5_int parent_id, const char* key);
+CJ5_API const char* cj5_get_string(cj5_result* r, cj5_int id, char* str, int max_str);
+// returns a pointer to the string in the source document and its length in `len`, without copying.
+// returns NULL if the string has escape sequences, use `cj5_get_string` or `cj5_unescape` for those.
+// `len` is set in both cases, and it's also enough buffer size for the decoded string
+CJ5_API const char* cj5_get_string_view(cj5_result* r, cj5_int id, cj5_int* len);
+CJ5_API double cj5_get_double(cj5_result* r, cj5_int id);
+CJ5_API float cj5_get_float(cj5_result* r, cj5_int id);
+CJ5_API int cj5_get_int(cj5_result* r, cj5_int id);
+CJ5_API uint32_t cj5_get_uint(cj5_result* r, cj5_int id);
+CJ5_API uint64_t cj5_get_uint64(cj5_result* r, cj5_int id);
+CJ5_API int64_t cj5_get_int64(cj5_result* r, cj5_int id);
+CJ5_API bool cj5_get_bool(cj5_result* r, cj5_int id);
+// same as integer getters above, but `overflow` (optional) is set if the number doesn't fit in the
+// return type. in that case, the value is clamped to the type's range
+CJ5_API int cj5_get_int_checked(cj5_result* r, cj5_int id, bool* overflow);
+CJ5_API uint32_t cj5_get_uint_checked(cj5_result* r, cj5_int id, bool* overflow);
+CJ5_API uint64_t cj5_get_uint64_checked(cj5_result* r, cj5_int id, bool* overflow);
+CJ5_API int64_t cj5_get_int64_checked(cj5_result* r, cj5_int id, bool* overflow);
+CJ5_API double cj5_seekget_double(cj5_result* r, cj5_int parent_id, const char* key, double def_val);
+CJ5_API float cj5_seekget_float(cj5_result* r, cj5_int parent_id, const char* key, float def_val);
+CJ5_API int cj5_seekget_array_int16(cj5_result* r, cj5_int parent_id, const char* key, int16_t* values, int max_values);
+CJ5_API int cj5_seekget_array_uint16(cj5_result* r, cj5_int parent_id, const char* key, uint16_t* values, int max_values);
+CJ5_API int cj5_seekget_int(cj5_result* r, cj5_int parent_id, const char* key, int def_val);
+CJ5_API uint32_t cj5_seekget_uint(cj5_result* r, cj5_int parent_id, const char* key, uint32_t def_val);
+CJ5_API uint64_t cj5_seekget_uint64(cj5_result* r, cj5_int parent_id, const char* key, uint64_t def_val);
+CJ5_API int64_t cj5_seekget_int64(cj5_result* r, cj5_int parent_id, const char* key, int64_t def_val);
+CJ5_API bool cj5_seekget_bool(cj5_result* r, cj5_int parent_id, const char* key, bool def_val);
+CJ5_API const char* cj5_seekget_string(cj5_result* r, cj5_int parent_id, const char* key, char* str, int max_str, const char* def_val);
+
+CJ5_API int cj5_seekget_array_double(cj5_result* r, cj5_int parent_id, const char* key, double* values, int max_values);
+CJ5_API int cj5_seekget_array_float(cj5_result* r, cj5_int parent_id, const char* key, float* values, int max_values);
+CJ5_API int cj5_seekget_array_int(cj5_result* r, cj5_int parent_id, const char* key, int* values, int max_values);
+CJ5_API int cj5_seekget_array_uint(cj5_result* r, cj5_int parent_id, const char* key, uint32_t* values, int max_values);
+CJ5_API int cj5_seekget_array_uint64(cj5_result* r, cj5_int parent_id, const char* key, uint64_t* values, int max_values);
+CJ5_API int cj5_seekget_array_int64(cj5_result* r, cj5_int parent_id, const char* key, int64_t* values, int max_values);
+CJ5_API int cj5_seekget_array_bool(cj5_result* r, cj5_int parent_id, const char* key, bool* values, int max_values);
+CJ5_API int cj5_seekget_array_string(cj5_result* r, cj5_int parent_id, const char* key, char** strs, int max_str, int max_values);
+CJ5_API cj5_int cj5_get_array_elem(cj5_result* r, cj5_int id, cj5_int index);
+// converts the numbers of array `id` into `values`, which is an array of `type`, in a single pass
+// returns the number of values written, stops at the first element that is not a number.
+// values that don't fit in `type` are clamped, and floats are truncated for integer types. the index
+// of the first element that is not a number, is clamped, or has a fraction that was cut off (2.7 or
+// -0.5, but not 1e3) is written to `invalid_index` (optional), otherwise -1
+CJ5_API int cj5_get_array_numbers(cj5_result* r, cj5_int id, cj5_array_type type, void* values,
+                                  int max_values, int* invalid_index);
+CJ5_API cj5_int cj5_get_array_elem_incremental(cj5_result* r, cj5_int id, cj5_int index,
+                                                cj5_int prev_elem);
+
+// compiles a path like "render.passes[2].shader" into pre-hashed keys and indices, so it can be
+// evaluated on any result without hashing or parsing the path again. keys are separated by '.' and
+// array indices are in brackets. returns false if the path is invalid or has more than
+// CJ5_PATH_MAX_STEPS steps. an empty path selects `parent_id` itself
+CJ5_API bool cj5_compile_path(cj5_path* path, const char* str);
+// returns the token id at `path` starting from `parent_id`, or -1 if it doesn't exist
+CJ5_API cj5_int cj5_query(cj5_result* r, cj5_int parent_id, const cj5_path* path);
+// resolves `num_paths` paths into `ids` (-1 for missing ones). every container is scanned once for
+// all the paths that go through it, instead of once per path
+CJ5_API void cj5_query_batch(cj5_result* r, cj5_int parent_id, const cj5_path* paths,
+                             int num_paths, cj5_int* ids);
+
+// binds the members of an object to the fields of a struct in one pass, see `cj5_bind`
+// `cj5_schema_init` hashes the keys of `fields` into a lookup table in `mem`, same as
+// `cj5_build_index`, it returns the number of bytes needed and doesn't build anything if `mem` is
+// NULL or smaller than that. returns -1 for more than CJ5_SCHEMA_MAX_FIELDS fields (nest objects).
+// `fields` and `mem` should stay valid as long as the schema is used, nested schemas need to be
+// initialized too
+CJ5_API cj5_int cj5_schema_init(cj5_schema* schema, const cj5_field* fields, int num_fields,
+                                void* mem, cj5_int mem_size);
+// writes the defaults of all the fields to `obj`, then the values of the members of object `id`
+// that match a field. members with a different type are skipped like the missing ones (like a
+// string for a number field, or null). duplicate keys resolve to the first one like `cj5_seek`.
+// returns the number of fields that were found
+CJ5_API int cj5_bind(cj5_result* r, cj5_int id, const cj5_schema* schema, void* obj);
+
+// cursor: reads a document on demand, without a token array. the cursor points to a value and moves
+// into objects and arrays. values that are not needed are skipped by matching brackets and quotes,
+// and the strings and primitives that are read are validated with the same rules as `cj5_parse`,
+// so the skipped parts of an invalid document are not reported. comments can be anywhere between
+// the values. cursors are plain structs, copy one to come back to its value later:
+//
+//        cj5_cursor root, window;
+//        cj5_cursor_init(&root, json, len);
+//        window = root;
+//        if (cj5_cursor_seek(&window, "window")) {
+//            cj5_cursor width = window;
+//            int w = cj5_cursor_seek(&width, "width") ? cj5_cursor_get_int(&width, 640) : 640;
+//        }
+//
+// the functions that move the cursor return false and leave it unchanged if the value doesn't
+// exist or on errors (see `cj5_cursor.error`)
+CJ5_API void cj5_cursor_init(cj5_cursor* c, const char* json5, cj5_int len);
+// type of the current value from its first character, NULL if there is an error
+CJ5_API cj5_token_type cj5_cursor_type(const cj5_cursor* c);
+// moves to the value of `key` in the current object, duplicate keys resolve to the first one
+CJ5_API bool cj5_cursor_seek(cj5_cursor* c, const char* key);
+CJ5_API bool cj5_cursor_seek_hash(cj5_cursor* c, uint32_t key_hash);
+// moves to element `index` of the current array
+CJ5_API bool cj5_cursor_elem(cj5_cursor* c, cj5_int index);
+// moves to the first member (value, with its key in `key_start`/`key_end`) or element of the
+// current object or array, returns false if it's empty
+CJ5_API bool cj5_cursor_enter(cj5_cursor* c);
+// skips the current value and moves to the next member or element, false at the end of container
+CJ5_API bool cj5_cursor_next(cj5_cursor* c);
+// parses the current value into tokens, so all the token helpers can be used on it (like
+// `cj5_bind`). token positions are relative to the value, the result's `json5` points to it
+CJ5_API cj5_result cj5_cursor_parse(cj5_cursor* c, cj5_token* tokens, cj5_int max_tokens);
+// read the current value, return `def_val` if it has another type
+CJ5_API double cj5_cursor_get_double(cj5_cursor* c, double def_val);
+CJ5_API float cj5_cursor_get_float(cj5_cursor* c, float def_val);
+CJ5_API int cj5_cursor_get_int(cj5_cursor* c, int def_val);
+CJ5_API uint32_t cj5_cursor_get_uint(cj5_cursor* c, uint32_t def_val);
+CJ5_API int64_t cj5_cursor_get_int64(cj5_cursor* c, int64_t def_val);
+CJ5_API uint64_t cj5_cursor_get_uint64(cj5_cursor* c, uint64_t def_val);
+CJ5_API bool cj5_cursor_get_bool(cj5_cursor* c, bool def_val);
+CJ5_API const char* cj5_cursor_get_string(cj5_cursor* c, char* str, int max_str,
+                                          const char* def_val);
+
+// builds open-addressing hash tables for objects with at least CJ5_INDEX_MIN_KEYS keys and attaches
+// them to the result, `cj5_seek`/`cj5_seek_hash` use them automatically.
+// returns the number of bytes needed. if `mem` is NULL or `mem_size` is smaller than that, nothing
+// is built, so you can call it once with NULL to get the size. `mem` must be pointer aligned and
+// stay valid as long as the result is used
+CJ5_API cj5_int cj5_build_index(cj5_result* r, void* mem, cj5_int mem_size);
+
+// writes token `id` and all of its children, keys with values as members of the current object
+CJ5_API void cj5_write_token(cj5_writer* w, cj5_result* r, cj5_int id);
 #endif
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -202,6 +700,23 @@ CJ5_API int cj5_get_array_elem_incremental(cj5_result* r, int id, int index, int
 #        define CJ5_MEMSET(_dst, _val, _size) memset((_dst), (_val), (_size))
 #    endif
 
+#    ifndef CJ5_MEMMOVE
+#        include <string.h>
+#        define CJ5_MEMMOVE(_dst, _src, _n) memmove((_dst), (_src), (_n))
+#    endif
+
+// statements that only exist with CJ5_STATS, so there is nothing left of them otherwise
+#    if CJ5_STATS
+#        define CJ5__STAT(...) __VA_ARGS__
+#        ifdef CJ5_STATS_CLOCK
+#            define CJ5__STAT_CLOCK() ((uint64_t)(CJ5_STATS_CLOCK()))
+#        else
+#            define CJ5__STAT_CLOCK() ((uint64_t)0)
+#        endif
+#    else
+#        define CJ5__STAT(...)
+#    endif
+
 #    define CJ5__ARCH_64BIT 0
 #    define CJ5__ARCH_32BIT 0
 #    if defined(__x86_64__) || defined(_M_X64) || defined(__aarch64__) || defined(__64BIT__) || \
@@ -213,12 +728,46 @@ CJ5_API int cj5_get_array_elem_incremental(cj5_result* r, int id, int index, int
 #        define CJ5__ARCH_32BIT 32
 #    endif    //
 
+#    if defined(_MSC_VER) || (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#        define CJ5__LITTLE_ENDIAN 1
+#    else
+#        define CJ5__LITTLE_ENDIAN 0
+#    endif
+
 #    if defined(_MSC_VER)
 #        define CJ5__RESTRICT __restrict
 #    else
 #        define CJ5__RESTRICT __restrict__
 #    endif
 
+#    ifndef CJ5_SIMD
+#        define CJ5_SIMD 1
+#    endif
+
+#    define CJ5__SIMD_AVX2 0
+#    define CJ5__SIMD_SSE2 0
+#    define CJ5__SIMD_NEON 0
+#    if CJ5_SIMD
+#        if defined(__AVX2__)
+#            include <immintrin.h>
+#            undef CJ5__SIMD_AVX2
+#            define CJ5__SIMD_AVX2 1
+#        elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#            include <emmintrin.h>
+#            undef CJ5__SIMD_SSE2
+#            define CJ5__SIMD_SSE2 1
+#        elif defined(__aarch64__) || defined(_M_ARM64)
+#            include <arm_neon.h>
+#            undef CJ5__SIMD_NEON
+#            define CJ5__SIMD_NEON 1
+#        endif
+#    endif
+#    define CJ5__SIMD (CJ5__SIMD_AVX2 || CJ5__SIMD_SSE2 || CJ5__SIMD_NEON)
+
+#    if defined(_MSC_VER)
+#        include <intrin.h>
+#    endif
+
 #    define CJ5__UNUSED(_a) (void)(_a)
 
 #    define CJ5__FOURCC(_a, _b, _c, _d) \
@@ -231,12 +780,12 @@ static const uint32_t CJ5__FALSE_FOURCC = CJ5__FOURCC('f', 'a', 'l', 's');
 static const uint32_t CJ5__FNV1_32_INIT = 0x811c9dc5;
 static const uint32_t CJ5__FNV1_32_PRIME = 0x01000193;
 
-typedef struct cj5__parser {
-    int pos;
-    int next_id;
-    int super_id;
-    int line;
-} cj5__parser;
+typedef enum cj5__pending {
+    CJ5__PENDING_NONE = 0,
+    CJ5__PENDING_DATA,                 // continue from `pos` when there is more data
+    CJ5__PENDING_COMMENT,              // inside a single line comment
+    CJ5__PENDING_MULTILINE_COMMENT     // inside a multiline comment
+} cj5__pending;
 
 static inline uint32_t cj5__hash_fnv32(const char* start, const char* end)
 {
@@ -277,10 +826,11 @@ static inline bool cj5__isnum(char ch)
     return cj5__isrange(ch, '0', '9');
 }
 
-static inline char* cj5__strcpy(char* CJ5__RESTRICT dst, int dst_sz, const char* CJ5__RESTRICT src, int num)
+static inline char* cj5__strcpy(char* CJ5__RESTRICT dst, int dst_sz, const char* CJ5__RESTRICT src,
+                                cj5_int num)
 {
     const int _max = dst_sz - 1;
-    const int _num = (num < _max ? num : _max);
+    const int _num = (int)(num < _max ? num : _max);
     if (_num > 0) {
         CJ5_MEMCPY(dst, src, _num);
     }
@@ -342,37 +892,352 @@ CJ5_SKIP_ASAN static int cj5__strlen(const char* str)
     #endif
 }
 
-static inline cj5_token* cj5__alloc_token(cj5__parser* parser, cj5_token* tokens, int max_tokens)
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Stage-1 scanner: finds the next character of interest 64 bytes at a time
+// The parser uses these to jump over string contents, comments, primitives and whitespace runs, so
+// the token building code only visits structural positions
+typedef enum cj5__scan_class {
+    CJ5__SCAN_STRING = 0,    // closing quote (passed as `ch`) or backslash
+    CJ5__SCAN_LINE_END,      // '\n' or '\r'
+    CJ5__SCAN_CHAR,          // single character (passed as `ch`)
+    CJ5__SCAN_PRIMITIVE,     // primitive terminators and invalid primitive characters
+    CJ5__SCAN_BLANK,         // anything that is not ' ' or '\t'
+    CJ5__SCAN_ESCAPE,        // characters that must be escaped in a JSON string: '"', '\\', control
+    CJ5__SCAN_STRUCTURE      // brackets, quotes and '/', for skipping values without parsing them
+} cj5__scan_class;
+
+static inline bool cj5__scan_match(char c, cj5__scan_class cls, char ch)
 {
-    if (!tokens || parser->next_id >= max_tokens) {
-        return NULL;
+    switch (cls) {
+    case CJ5__SCAN_STRING:      return c == ch || c == '\\';
+    case CJ5__SCAN_LINE_END:    return c == '\n' || c == '\r';
+    case CJ5__SCAN_CHAR:        return c == ch;
+    case CJ5__SCAN_PRIMITIVE:
+        return (uint8_t)c <= 32 || (uint8_t)c >= 127 || c == ':' || c == ',' || c == ']' || c == '}';
+    case CJ5__SCAN_BLANK:       return c != ' ' && c != '\t';
+    case CJ5__SCAN_ESCAPE:      return c == '"' || c == '\\' || (uint8_t)c < 32;
+    case CJ5__SCAN_STRUCTURE:
+        // '[' and ']' are '{' and '}' without bit 0x20
+        return (c | 0x20) == '{' || (c | 0x20) == '}' || c == '"' || c == '\'' || c == '/';
+    }
+    return true;
+}
+
+static inline int cj5__ctz64(uint64_t v)
+{
+#    if defined(_MSC_VER)
+    unsigned long index;
+#        if CJ5__ARCH_64BIT
+    _BitScanForward64(&index, v);
+#        else
+    if (!_BitScanForward(&index, (unsigned long)v)) {
+        _BitScanForward(&index, (unsigned long)(v >> 32));
+        index += 32;
+    }
+#        endif
+    return (int)index;
+#    else
+    return __builtin_ctzll(v);
+#    endif
+}
+
+static inline int cj5__clz64(uint64_t v)
+{
+#    if defined(_MSC_VER)
+    unsigned long index;
+#        if CJ5__ARCH_64BIT
+    _BitScanReverse64(&index, v);
+#        else
+    if (_BitScanReverse(&index, (unsigned long)(v >> 32))) {
+        index += 32;
+    } else {
+        _BitScanReverse(&index, (unsigned long)v);
     }
+#        endif
+    return 63 - (int)index;
+#    else
+    return __builtin_clzll(v);
+#    endif
+}
+
+// returns the low 64 bits of a*b, the high part goes to `hi`
+static inline uint64_t cj5__mul128(uint64_t a, uint64_t b, uint64_t* hi)
+{
+#    if defined(__SIZEOF_INT128__)
+    __uint128_t r = (__uint128_t)a * b;
+    *hi = (uint64_t)(r >> 64);
+    return (uint64_t)r;
+#    elif defined(_MSC_VER) && defined(_M_X64)
+    return _umul128(a, b, hi);
+#    else
+    uint64_t a_lo = (uint32_t)a, a_hi = a >> 32;
+    uint64_t b_lo = (uint32_t)b, b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo;
+    uint64_t hi_lo = a_hi * b_lo;
+    uint64_t cross = (lo_lo >> 32) + (uint32_t)hi_lo + a_lo * b_hi;
+    *hi = (hi_lo >> 32) + (cross >> 32) + a_hi * b_hi;
+    return (cross << 32) | (uint32_t)lo_lo;
+#    endif
+}
+
+#    if CJ5__SIMD
+#        if CJ5__SIMD_AVX2
+typedef __m256i cj5__vec;
+#            define CJ5__VEC_SIZE 32
+static inline cj5__vec cj5__vec_load(const char* p) { return _mm256_loadu_si256((const __m256i*)p); }
+static inline cj5__vec cj5__vec_splat(char c) { return _mm256_set1_epi8(c); }
+static inline cj5__vec cj5__vec_eq(cj5__vec a, cj5__vec b) { return _mm256_cmpeq_epi8(a, b); }
+static inline cj5__vec cj5__vec_or(cj5__vec a, cj5__vec b) { return _mm256_or_si256(a, b); }
+// lanes where (uint8_t)a <= (uint8_t)b
+static inline cj5__vec cj5__vec_le(cj5__vec a, cj5__vec b) { return _mm256_cmpeq_epi8(_mm256_min_epu8(a, b), a); }
+static inline uint64_t cj5__vec_mask(cj5__vec v) { return (uint32_t)_mm256_movemask_epi8(v); }
+#        elif CJ5__SIMD_SSE2
+typedef __m128i cj5__vec;
+#            define CJ5__VEC_SIZE 16
+static inline cj5__vec cj5__vec_load(const char* p) { return _mm_loadu_si128((const __m128i*)p); }
+static inline cj5__vec cj5__vec_splat(char c) { return _mm_set1_epi8(c); }
+static inline cj5__vec cj5__vec_eq(cj5__vec a, cj5__vec b) { return _mm_cmpeq_epi8(a, b); }
+static inline cj5__vec cj5__vec_or(cj5__vec a, cj5__vec b) { return _mm_or_si128(a, b); }
+static inline cj5__vec cj5__vec_le(cj5__vec a, cj5__vec b) { return _mm_cmpeq_epi8(_mm_min_epu8(a, b), a); }
+static inline uint64_t cj5__vec_mask(cj5__vec v) { return (uint32_t)_mm_movemask_epi8(v); }
+#        elif CJ5__SIMD_NEON
+typedef uint8x16_t cj5__vec;
+#            define CJ5__VEC_SIZE 16
+static inline cj5__vec cj5__vec_load(const char* p) { return vld1q_u8((const uint8_t*)p); }
+static inline cj5__vec cj5__vec_splat(char c) { return vdupq_n_u8((uint8_t)c); }
+static inline cj5__vec cj5__vec_eq(cj5__vec a, cj5__vec b) { return vceqq_u8(a, b); }
+static inline cj5__vec cj5__vec_or(cj5__vec a, cj5__vec b) { return vorrq_u8(a, b); }
+static inline cj5__vec cj5__vec_le(cj5__vec a, cj5__vec b) { return vcleq_u8(a, b); }
+static inline uint64_t cj5__vec_mask(cj5__vec v)
+{
+    static const uint8_t weights[16] = { 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+    uint8x16_t m = vandq_u8(v, vld1q_u8(weights));
+    return (uint64_t)vaddv_u8(vget_low_u8(m)) | ((uint64_t)vaddv_u8(vget_high_u8(m)) << 8);
+}
+#        endif
+
+// returns a bitmask of the characters in p[0..63] that match the class
+static inline uint64_t cj5__scan_mask(const char* p, cj5__scan_class cls, char ch)
+{
+    uint64_t mask = 0;
+    for (int i = 0; i < 64; i += CJ5__VEC_SIZE) {
+        cj5__vec v = cj5__vec_load(p + i);
+        cj5__vec m;
+        switch (cls) {
+        case CJ5__SCAN_STRING:
+            m = cj5__vec_or(cj5__vec_eq(v, cj5__vec_splat(ch)), cj5__vec_eq(v, cj5__vec_splat('\\')));
+            break;
+        case CJ5__SCAN_LINE_END:
+            m = cj5__vec_or(cj5__vec_eq(v, cj5__vec_splat('\n')), cj5__vec_eq(v, cj5__vec_splat('\r')));
+            break;
+        case CJ5__SCAN_CHAR:
+            m = cj5__vec_eq(v, cj5__vec_splat(ch));
+            break;
+        case CJ5__SCAN_PRIMITIVE:
+            m = cj5__vec_or(cj5__vec_le(v, cj5__vec_splat(32)), cj5__vec_le(cj5__vec_splat(127), v));
+            m = cj5__vec_or(m, cj5__vec_or(cj5__vec_eq(v, cj5__vec_splat(':')),
+                                           cj5__vec_eq(v, cj5__vec_splat(','))));
+            m = cj5__vec_or(m, cj5__vec_or(cj5__vec_eq(v, cj5__vec_splat(']')),
+                                           cj5__vec_eq(v, cj5__vec_splat('}'))));
+            break;
+        case CJ5__SCAN_ESCAPE:
+            m = cj5__vec_or(cj5__vec_eq(v, cj5__vec_splat('"')), cj5__vec_eq(v, cj5__vec_splat('\\')));
+            m = cj5__vec_or(m, cj5__vec_le(v, cj5__vec_splat(31)));
+            break;
+        case CJ5__SCAN_STRUCTURE: {
+            cj5__vec b = cj5__vec_or(v, cj5__vec_splat(0x20));
+            m = cj5__vec_or(cj5__vec_eq(b, cj5__vec_splat('{')), cj5__vec_eq(b, cj5__vec_splat('}')));
+            m = cj5__vec_or(m, cj5__vec_or(cj5__vec_eq(v, cj5__vec_splat('"')),
+                                           cj5__vec_eq(v, cj5__vec_splat('\''))));
+            m = cj5__vec_or(m, cj5__vec_eq(v, cj5__vec_splat('/')));
+            break;
+        }
+        default:    // CJ5__SCAN_BLANK: match the blanks here and invert the whole mask below
+            m = cj5__vec_or(cj5__vec_eq(v, cj5__vec_splat(' ')), cj5__vec_eq(v, cj5__vec_splat('\t')));
+            break;
+        }
+        mask |= cj5__vec_mask(m) << i;
+    }
+    return cls == CJ5__SCAN_BLANK ? ~mask : mask;
+}
+#    endif    // CJ5__SIMD
+
+// returns the position of the first character in json5[pos..len) that matches the class or `len`
+static inline cj5_int cj5__scan(const char* json5, cj5_int pos, cj5_int len, cj5__scan_class cls,
+                                char ch)
+{
+#    if CJ5__SIMD
+    for (; pos + 64 <= len; pos += 64) {
+        uint64_t mask = cj5__scan_mask(&json5[pos], cls, ch);
+        if (mask) {
+            return pos + cj5__ctz64(mask);
+        }
+    }
+#    endif
+    for (; pos < len; pos++) {
+        if (cj5__scan_match(json5[pos], cls, ch)) {
+            return pos;
+        }
+    }
+    return len;
+}
 
-    cj5_token* token = &tokens[parser->next_id++];
+static bool cj5__grow_tokens(cj5_parser* parser)
+{
+    cj5_int max_tokens = parser->max_tokens < 32 ? 64 : parser->max_tokens * 2;
+    if (max_tokens <= parser->max_tokens) {
+        return false;
+    }
+
+    cj5_token* tokens = (cj5_token*)parser->realloc_fn(parser->tokens,
+                                                       (size_t)max_tokens * sizeof(cj5_token),
+                                                       parser->realloc_user);
+    if (!tokens) {
+        return false;
+    }
+
+    parser->tokens = tokens;
+    parser->max_tokens = max_tokens;
+    CJ5__STAT(parser->result.stats.num_grows++;)
+    return true;
+}
+
+static inline cj5_token* cj5__alloc_token(cj5_parser* parser)
+{
+    if (parser->next_id >= parser->max_tokens || !parser->tokens) {
+        // once we failed to grow, just keep counting the tokens like the fixed size array
+        if (!parser->realloc_fn || parser->result.error == CJ5_ERROR_OVERFLOW ||
+            !cj5__grow_tokens(parser)) {
+            return NULL;
+        }
+    }
+
+    cj5_token* token = &parser->tokens[parser->next_id++];
     CJ5_MEMSET(token, 0x0, sizeof(cj5_token));
     token->start = -1;
     token->end = -1;
     token->parent_id = -1;
+    token->next_id = parser->next_id;
     return token;
 }
 
-static inline void cj5__set_error(cj5_result* r, cj5_error_code code, int line, int col)
+static inline void cj5__set_error(cj5_result* r, cj5_error_code code, cj5_int line, cj5_int col)
 {
     r->error = code;
     r->error_line = line + 1;
     r->error_col = col + 1;
 }
 
-static bool cj5__parse_primitive(cj5__parser* parser, cj5_result* r, const char* json5, int len,
-                                 cj5_token* tokens, int max_tokens)
+// type of the primitive json5[start..end), -1 if it's not valid. `keyname`: the primitive is before
+// a ':'. `start` moves past a '+' sign and the "0x" of hex numbers, where the token starts
+static inline int cj5__primitive_type(const char* json5, cj5_int* start, cj5_int end, bool keyname,
+                                      cj5_token_number_type* num_type)
+{
+    *num_type = CJ5_TOKEN_NUMBER_UNKNOWN;
+    if (keyname) {
+        // JSON5: it is likely a key-name, validate and interpret as string
+        for (cj5_int i = *start; i < end; i++) {
+            if (cj5__islowerchar(json5[i]) || cj5__isupperchar(json5[i]) || json5[i] == '_') {
+                continue;
+            }
+
+            if (cj5__isnum(json5[i])) {
+                if (i == *start) {
+                    return -1;
+                }
+                continue;
+            }
+            return -1;
+        }
+        return CJ5_TOKEN_STRING;
+    }
+
+    // detect other types, subtypes
+    // note that we have to use memcpy here or we will get unaligned access on some
+    // shorter primitives can't be keywords, and reading 4 bytes could go past the received data
+    uint32_t fourcc = 0;
+    if (end - *start >= 4) {
+        CJ5_MEMCPY(&fourcc, &json5[*start], 4);
+    }
+
+    if (fourcc == CJ5__NULL_FOURCC) {
+        return CJ5_TOKEN_NULL;
+    } else if (fourcc == CJ5__TRUE_FOURCC || fourcc == CJ5__FALSE_FOURCC) {
+        return CJ5_TOKEN_BOOL;
+    }
+
+    *num_type = CJ5_TOKEN_NUMBER_INT;
+    // hex number
+    if (json5[*start] == '0' && *start + 1 < end && json5[*start + 1] == 'x') {
+        *start += 2;
+        for (cj5_int i = *start; i < end; i++) {
+            if (!(cj5__isrange(json5[i], '0', '9') || cj5__isrange(json5[i], 'A', 'F') ||
+                  cj5__isrange(json5[i], 'a', 'f'))) {
+                return -1;
+            }
+        }
+        *num_type = CJ5_TOKEN_NUMBER_HEX;
+        return CJ5_TOKEN_NUMBER;
+    }
+
+    cj5_int start_index = *start;
+    if (json5[*start] == '+') {
+        ++start_index;
+        ++*start;
+    } else if (json5[*start] == '-') {
+        ++start_index;
+    }
+
+    bool has_digits = false;
+    bool has_exp = false;
+    for (cj5_int i = start_index; i < end; i++) {
+        if (json5[i] == '.') {
+            if (*num_type == CJ5_TOKEN_NUMBER_FLOAT) {
+                return -1;
+            }
+            *num_type = CJ5_TOKEN_NUMBER_FLOAT;
+            continue;
+        }
+
+        // exponent: needs digits before and after, like 1e5, 1.5E-3
+        if (json5[i] == 'e' || json5[i] == 'E') {
+            if (has_exp || !has_digits) {
+                return -1;
+            }
+            if (i + 1 < end && (json5[i + 1] == '+' || json5[i + 1] == '-')) {
+                ++i;
+            }
+            if (i + 1 == end) {
+                return -1;
+            }
+            has_exp = true;
+            *num_type = CJ5_TOKEN_NUMBER_FLOAT;
+            continue;
+        }
+        has_digits = true;
+
+        if (!cj5__isnum(json5[i])) {
+            return -1;
+        }
+    }
+    return CJ5_TOKEN_NUMBER;
+}
+
+static bool cj5__parse_primitive(cj5_parser* parser, const char* json5, cj5_int len, bool final)
 {
+    cj5_result* r = &parser->result;
     cj5_token* token;
-    int start = parser->pos;
-    int line_start = start;
+    cj5_int start = parser->pos;
+    cj5_int line_start = start;
     bool keyname = false;
     bool new_line = false;
 
     for (; parser->pos < len; parser->pos++) {
+        parser->pos = cj5__scan(json5, parser->pos, len, CJ5__SCAN_PRIMITIVE, 0);
+        if (parser->pos == len) {
+            break;
+        }
+
         switch (json5[parser->pos]) {
         case '\n':
             line_start = parser->pos;
@@ -399,109 +1264,38 @@ static bool cj5__parse_primitive(cj5__parser* parser, cj5_result* r, const char*
         }
     }
 
+    if (!final) {
+        // the primitive may continue in the next chunk of data
+        parser->pending = CJ5__PENDING_DATA;
+        parser->pos = start;
+        return true;
+    }
+
     cj5__set_error(r, CJ5_ERROR_INCOMPLETE, parser->line, parser->pos - line_start);
     parser->pos = start;
     return false;
 
 found:
-    token = cj5__alloc_token(parser, tokens, max_tokens);
+    token = cj5__alloc_token(parser);
     if (token == NULL) {
         r->error = CJ5_ERROR_OVERFLOW;
         --parser->pos;
         return true;
     }
 
-    cj5_token_type type;
-    cj5_token_number_type num_type = CJ5_TOKEN_NUMBER_UNKNOWN;
-    if (keyname) {
-        // JSON5: it is likely a key-name, validate and interpret as string
-        for (int i = start; i < parser->pos; i++) {
-            if (cj5__islowerchar(json5[i]) || cj5__isupperchar(json5[i]) || json5[i] == '_') {
-                continue;
-            }
-
-            if (cj5__isnum(json5[i])) {
-                if (i == start) {
-                    cj5__set_error(r, CJ5_ERROR_INVALID, parser->line, parser->pos - line_start);
-                    parser->pos = start;
-                    return false;
-                }
-                continue;
-            }
-
-            cj5__set_error(r, CJ5_ERROR_INVALID, parser->line, parser->pos - line_start);
-            parser->pos = start;
-            return false;
-        }
-
-        type = CJ5_TOKEN_STRING;
-    } else {
-        // detect other types, subtypes
-        // note that we have to use memcpy here or we will get unaligned access on some
-        uint32_t fourcc_;
-        CJ5_MEMCPY(&fourcc_, &json5[start], 4);
-        uint32_t* fourcc = &fourcc_;
- 
-        if (*fourcc == CJ5__NULL_FOURCC) {
-            type = CJ5_TOKEN_NULL;
-        } else if (*fourcc == CJ5__TRUE_FOURCC) {
-            type = CJ5_TOKEN_BOOL;
-        } else if (*fourcc == CJ5__FALSE_FOURCC) {
-            type = CJ5_TOKEN_BOOL;
-        } else {
-            num_type = CJ5_TOKEN_NUMBER_INT;
-            // hex number
-            if (json5[start] == '0' && start < parser->pos + 1 && json5[start + 1] == 'x') {
-                start = start + 2;
-                for (int i = start; i < parser->pos; i++) {
-                    if (!(cj5__isrange(json5[i], '0', '9') || cj5__isrange(json5[i], 'A', 'F') ||
-                          cj5__isrange(json5[i], 'a', 'f'))) {
-                        cj5__set_error(r, CJ5_ERROR_INVALID, parser->line,
-                                       parser->pos - line_start);
-                        parser->pos = start;
-                        return false;
-                    }
-                }
-                num_type = CJ5_TOKEN_NUMBER_HEX;
-            } else {
-                int start_index = start;
-                if (json5[start] == '+') {
-                    ++start_index;
-                    ++start;
-                } else if (json5[start] == '-') {
-                    ++start_index;
-                }
-
-                for (int i = start_index; i < parser->pos; i++) {
-                    if (json5[i] == '.') {
-                        if (num_type == CJ5_TOKEN_NUMBER_FLOAT) {
-                            cj5__set_error(r, CJ5_ERROR_INVALID, parser->line,
-                                           parser->pos - line_start);
-                            parser->pos = start;
-                            return false;
-                        }
-                        num_type = CJ5_TOKEN_NUMBER_FLOAT;
-                        continue;
-                    }
-
-                    if (!cj5__isnum(json5[i])) {
-                        cj5__set_error(r, CJ5_ERROR_INVALID, parser->line,
-                                       parser->pos - line_start);
-                        parser->pos = start;
-                        return false;
-                    }
-                }
-            }
-
-            type = CJ5_TOKEN_NUMBER;
-        }
+    cj5_token_number_type num_type;
+    int type = cj5__primitive_type(json5, &start, parser->pos, keyname, &num_type);
+    if (type < 0) {
+        cj5__set_error(r, CJ5_ERROR_INVALID, parser->line, parser->pos - line_start);
+        parser->pos = start;
+        return false;
     }
 
     if (new_line) {
         ++parser->line;
     }
 
-    token->type = type;
+    token->type = (cj5_token_type)type;
     if (type == CJ5_TOKEN_STRING) {
         token->key_hash = cj5__hash_fnv32(&json5[start], &json5[parser->pos]);
         token->key_start = start;
@@ -516,21 +1310,27 @@ found:
     return true;
 }
 
-static bool cj5__parse_string(cj5__parser* parser, cj5_result* r, const char* json5, int len,
-                              cj5_token* tokens, int max_tokens)
+static bool cj5__parse_string(cj5_parser* parser, const char* json5, cj5_int len, bool final)
 {
+    cj5_result* r = &parser->result;
     cj5_token* token;
-    int start = parser->pos;
-    int line_start = start;
+    cj5_int start = parser->pos;
+    cj5_int line = parser->line;
+    cj5_int line_start = start;
     char str_open = json5[start];
+    bool escaped = false;
     ++parser->pos;
 
     for (; parser->pos < len; parser->pos++) {
+        parser->pos = cj5__scan(json5, parser->pos, len, CJ5__SCAN_STRING, str_open);
+        if (parser->pos == len) {
+            break;
+        }
         char c = json5[parser->pos];
 
         // end of string
         if (str_open == c) {
-            token = cj5__alloc_token(parser, tokens, max_tokens);
+            token = cj5__alloc_token(parser);
             if (token == NULL) {
                 r->error = CJ5_ERROR_OVERFLOW;
                 return true;
@@ -540,14 +1340,17 @@ static bool cj5__parse_string(cj5__parser* parser, cj5_result* r, const char* js
             token->start = start + 1;
             token->end = parser->pos;
             token->parent_id = parser->super_id;
+            token->escaped = escaped;
 
             return true;
         }
 
         if (c == '\\' && parser->pos + 1 < len) {
+            escaped = true;
             ++parser->pos;
             switch (json5[parser->pos]) {
             case '\"':
+            case '\'':
             case '/':
             case '\\':
             case 'b':
@@ -585,679 +1388,4822 @@ static bool cj5__parse_string(cj5__parser* parser, cj5_result* r, const char* js
         }
     }
 
+    if (!final) {
+        // the string may continue in the next chunk of data, scan it again from the start
+        parser->pending = CJ5__PENDING_DATA;
+        parser->line = line;
+        parser->pos = start;
+        return true;
+    }
+
+    cj5__set_error(r, CJ5_ERROR_INCOMPLETE, parser->line, parser->pos - line_start);
     parser->pos = start;
-    return true;
+    return false;
 }
 
-static void cj5__skip_comment(cj5__parser* parser, const char* json5, int len)
+static void cj5__skip_comment(cj5_parser* parser, const char* json5, cj5_int len)
+{
+    parser->pos = cj5__scan(json5, parser->pos, len, CJ5__SCAN_LINE_END, 0);
+}
+
+static void cj5__skip_multiline_comment(cj5_parser* parser, const char* json5, cj5_int len)
 {
     for (; parser->pos < len; parser->pos++) {
-        if (json5[parser->pos] == '\n' || json5[parser->pos] == '\r') {
+        parser->pos = cj5__scan(json5, parser->pos, len, CJ5__SCAN_CHAR, '*');
+        if (parser->pos == len || (parser->pos < (len - 1) && json5[parser->pos+1] == '/')) {
             return;
         }
     }
 }
 
-static void cj5__skip_multiline_comment(cj5__parser* parser, const char* json5, int len)
+static void cj5__suspend_comment(cj5_parser* parser, const char* json5, cj5_int len,
+                                  cj5__pending pending)
 {
-    for (; parser->pos < len; parser->pos++) {
-        if (json5[parser->pos] == '*' && parser->pos < (len - 1) && json5[parser->pos+1] == '/') {
-            return;
-        }
+    // a trailing '*' can be the start of "*/" in the next chunk of data
+    if (pending == CJ5__PENDING_MULTILINE_COMMENT && len > 0 && json5[len - 1] == '*') {
+        parser->pos = len - 1;
+        // the '*' is counted again when the comment continues
+        CJ5__STAT(parser->result.stats.bytes_comments--;)
     }
+    parser->pending = pending;
 }
 
-cj5_result cj5_parse(const char* json5, int len, cj5_token* tokens, int max_tokens)
+// counts a new token as a child of the current container or key
+static inline void cj5__add_child(cj5_parser* parser, const char* json5)
 {
-    cj5__parser parser;
-    CJ5_MEMSET(&parser, 0x0, sizeof(parser));
-    parser.super_id = -1;
+    if (parser->super_id != -1 && parser->tokens && parser->result.error != CJ5_ERROR_OVERFLOW) {
+        cj5_token* super_token = &parser->tokens[parser->super_id];
+        if (++super_token->size == 1 && super_token->type == CJ5_TOKEN_STRING) {
+            // it's not a value, it's a key, so hash it
+            super_token->key_hash =
+                cj5__hash_fnv32(&json5[super_token->start], &json5[super_token->end]);
+            super_token->key_start = super_token->start;
+            super_token->key_end = super_token->end;
+        }
+    }
+}
 
-    cj5_result r;
-    CJ5_MEMSET(&r, 0x0, sizeof(r));
+static inline void cj5__open(cj5_parser* parser, cj5_int id, const char* json5)
+{
+    if (parser->super_id != -1) {
+        parser->tokens[id].parent_id = parser->super_id;
+        cj5__add_child(parser, json5);
+    }
+    parser->super_id = id;
+}
 
-    cj5_token* token;
-    int count = parser.next_id;
-    bool can_comment = false;
+// '}' or ']' at `pos`: finds the container that it closes, returns false on syntax error
+static bool cj5__close(cj5_parser* parser, char c, cj5_int pos)
+{
+    cj5_result* r = &parser->result;
+    cj5_token_type type = (c == '}' ? CJ5_TOKEN_OBJECT : CJ5_TOKEN_ARRAY);
 
-    for (; parser.pos < len; parser.pos++) {
-        char c;
-        cj5_token_type type;
+    if (parser->next_id < 1) {
+        cj5__set_error(r, CJ5_ERROR_INVALID, parser->line, pos - parser->line);
+        return false;
+    }
 
-        c = json5[parser.pos];
-        switch (c) {
-        case '{':
-        case '[':
-            can_comment = false;
-            count++;
-            token = cj5__alloc_token(&parser, tokens, max_tokens);
-            if (token == NULL) {
-                r.error = CJ5_ERROR_OVERFLOW;
-                break;
+    // all tokens on the way up contain the last token, so their children end here
+    cj5_token* token = &parser->tokens[parser->next_id - 1];
+    CJ5__STAT(cj5_int walk = 0;)
+    for (;;) {
+        CJ5__STAT(walk++;)
+        token->next_id = parser->next_id;
+        if (token->start != -1 && token->end == -1) {
+            if (token->type != type) {
+                cj5__set_error(r, CJ5_ERROR_INVALID, parser->line, pos - parser->line);
+                return false;
             }
+            token->end = pos + 1;
+            parser->super_id = token->parent_id;
+            break;
+        }
 
-            if (parser.super_id != -1) {
-                cj5_token* super_token = &tokens[parser.super_id];
-                token->parent_id = parser.super_id;
-                if (++super_token->size == 1 && super_token->type == CJ5_TOKEN_STRING) {
-                    super_token->key_hash =
-                        cj5__hash_fnv32(&json5[super_token->start], &json5[super_token->end]);
-                    super_token->key_start = super_token->start;
-                    super_token->key_end = super_token->end;
-                }
+        if (token->parent_id == -1) {
+            if (token->type != type || parser->super_id == -1) {
+                cj5__set_error(r, CJ5_ERROR_INVALID, parser->line, pos - parser->line);
+                return false;
             }
-
-            token->type = (c == '{' ? CJ5_TOKEN_OBJECT : CJ5_TOKEN_ARRAY);
-            token->start = parser.pos;
-            parser.super_id = parser.next_id - 1;
             break;
+        }
 
-        case '}':
-        case ']':
-            can_comment = false;
-            if (!tokens || r.error == CJ5_ERROR_OVERFLOW) {
-                break;
-            }
-            type = (c == '}' ? CJ5_TOKEN_OBJECT : CJ5_TOKEN_ARRAY);
+        token = &parser->tokens[token->parent_id];
+    }
+    CJ5__STAT(if (walk > r->stats.max_close_walk) r->stats.max_close_walk = walk;)
+    return true;
+}
 
-            if (parser.next_id < 1) {
-                cj5__set_error(&r, CJ5_ERROR_INVALID, parser.line, parser.pos - parser.line);
-                return r;
-            }
+static inline void cj5__comma(cj5_parser* parser)
+{
+    if (parser->tokens != NULL && parser->super_id != -1 &&
+        parser->result.error != CJ5_ERROR_OVERFLOW &&
+        parser->tokens[parser->super_id].type != CJ5_TOKEN_ARRAY &&
+        parser->tokens[parser->super_id].type != CJ5_TOKEN_OBJECT) {
+        parser->tokens[parser->super_id].next_id = parser->next_id;
+        parser->super_id = parser->tokens[parser->super_id].parent_id;
+    }
+}
 
-            token = &tokens[parser.next_id - 1];
-            for (;;) {
-                if (token->start != -1 && token->end == -1) {
-                    if (token->type != type) {
-                        cj5__set_error(&r, CJ5_ERROR_INVALID, parser.line,
-                                       parser.pos - parser.line);
-                        return r;
-                    }
-                    token->end = parser.pos + 1;
-                    parser.super_id = token->parent_id;
-                    break;
-                }
+// parallel parsing: structural characters are recorded and applied after all chunks are parsed
+static void cj5__chunk_mark(cj5_parser* parser, cj5_int pos);
 
-                if (token->parent_id == -1) {
-                    if (token->type != type || parser.super_id == -1) {
-                        cj5__set_error(&r, CJ5_ERROR_INVALID, parser.line,
-                                       parser.pos - parser.line);
-                        return r;
-                    }
-                    break;
-                }
+#if CJ5_STATS
+// json5[start..end) is a primitive. without a token (CJ5_ERROR_OVERFLOW) the type is guessed
+static void cj5__stats_primitive(cj5_parser* parser, const char* json5, cj5_int start, cj5_int end,
+                                 cj5_int len)
+{
+    cj5_stats* stats = &parser->result.stats;
+    cj5_token_type type;
+    if (parser->tokens && parser->result.error != CJ5_ERROR_OVERFLOW) {
+        type = parser->tokens[parser->next_id - 1].type;
+    } else if (end < len && json5[end] == ':') {
+        type = CJ5_TOKEN_STRING;
+    } else if (cj5__isnum(json5[start]) || json5[start] == '-' || json5[start] == '+' ||
+               json5[start] == '.') {
+        type = CJ5_TOKEN_NUMBER;
+    } else {
+        type = json5[start] == 'n' ? CJ5_TOKEN_NULL : CJ5_TOKEN_BOOL;
+    }
+
+    stats->num_tokens[type]++;
+    if (type == CJ5_TOKEN_STRING) {
+        stats->bytes_strings += end - start;
+    } else if (type == CJ5_TOKEN_NUMBER) {
+        stats->bytes_numbers += end - start;
+    } else {
+        stats->bytes_literals += end - start;
+    }
+}
+#endif
+
+// parses json5[pos..stop), strings, primitives and comments that start before `stop` can go on to `len`
+static void cj5__parse_run(cj5_parser* parser, const char* json5, cj5_int stop, cj5_int len,
+                           bool final)
+{
+    cj5_result* r = &parser->result;
+    cj5_token* token;
+    CJ5__STAT(cj5_int stat_pos = parser->pos; uint64_t stat_clock = CJ5__STAT_CLOCK();)
+
+    // continue the comment that was cut at the end of previous data
+    if (parser->pending == CJ5__PENDING_COMMENT || parser->pending == CJ5__PENDING_MULTILINE_COMMENT) {
+        cj5__pending pending = (cj5__pending)parser->pending;
+        if (pending == CJ5__PENDING_COMMENT) {
+            cj5__skip_comment(parser, json5, len);
+        } else {
+            cj5__skip_multiline_comment(parser, json5, len);
+        }
+        // multiline comments stop at the '*' of "*/"
+        CJ5__STAT(cj5_int comment_end = parser->pos;
+                  if (pending == CJ5__PENDING_MULTILINE_COMMENT && comment_end < len) comment_end += 2;
+                  r->stats.bytes_comments += comment_end - stat_pos;
+                  r->stats.cycles_comments += CJ5__STAT_CLOCK() - stat_clock;)
+
+        if (parser->pos == len && !final) {
+            cj5__suspend_comment(parser, json5, len, pending);
+            return;
+        }
+        parser->pos++;
+    }
+    parser->pending = CJ5__PENDING_NONE;
+
+    for (; parser->pos < stop; parser->pos++) {
+        char c = json5[parser->pos];
+        switch (c) {
+        case '{':
+        case '[':
+            parser->can_comment = false;
+            CJ5__STAT(r->stats.num_tokens[c == '{' ? CJ5_TOKEN_OBJECT : CJ5_TOKEN_ARRAY]++;
+                      if (!parser->chunk && ++parser->depth > r->stats.max_depth)
+                          r->stats.max_depth = parser->depth;)
+            parser->num_tokens++;
+            token = cj5__alloc_token(parser);
+            if (token == NULL) {
+                r->error = CJ5_ERROR_OVERFLOW;
+                break;
+            }
+
+            token->type = (c == '{' ? CJ5_TOKEN_OBJECT : CJ5_TOKEN_ARRAY);
+            token->start = parser->pos;
+            if (!parser->chunk) {
+                cj5__open(parser, parser->next_id - 1, json5);
+            }
+            break;
 
-                token = &tokens[token->parent_id];
+        case '}':
+        case ']':
+            parser->can_comment = false;
+            CJ5__STAT(if (!parser->chunk && parser->depth > 0) parser->depth--;)
+            if (parser->chunk) {
+                cj5__chunk_mark(parser, parser->pos);
+                break;
             }
+            if ((!parser->tokens && !parser->realloc_fn) || r->error == CJ5_ERROR_OVERFLOW) {
+                break;
+            }
+            CJ5__STAT(stat_clock = CJ5__STAT_CLOCK();)
+            if (!cj5__close(parser, c, parser->pos)) {
+                return;
+            }
+            CJ5__STAT(r->stats.cycles_brackets += CJ5__STAT_CLOCK() - stat_clock;)
             break;
 
         case '\"':
         case '\'':
-            can_comment = false;
+            parser->can_comment = false;
             // JSON5: strings can start with \" or \'
-            cj5__parse_string(&parser, &r, json5, len, tokens, max_tokens);
-            if (r.error && r.error != CJ5_ERROR_OVERFLOW) {
+            CJ5__STAT(stat_pos = parser->pos; stat_clock = CJ5__STAT_CLOCK();)
+            cj5__parse_string(parser, json5, len, final);
+            CJ5__STAT(r->stats.cycles_strings += CJ5__STAT_CLOCK() - stat_clock;)
+            if ((r->error && r->error != CJ5_ERROR_OVERFLOW) || parser->pending) {
+                return;
+            }
+            CJ5__STAT(r->stats.bytes_strings += parser->pos + 1 - stat_pos;
+                      r->stats.num_tokens[CJ5_TOKEN_STRING]++;)
+            parser->num_tokens++;
+            cj5__add_child(parser, json5);
+            break;
+
+        case '\r':
+            parser->can_comment = true;
+            CJ5__STAT(r->stats.bytes_whitespace++;)
+            break;
+        case '\n':
+            ++parser->line;
+            parser->can_comment = true;
+            CJ5__STAT(r->stats.bytes_whitespace++;)
+            break;
+        case '\t':
+        case ' ':
+            CJ5__STAT(stat_pos = parser->pos;)
+            // skip the rest of whitespace run (indentation)
+            if (parser->pos + 1 < len && (json5[parser->pos + 1] == ' ' || json5[parser->pos + 1] == '\t')) {
+                parser->pos = cj5__scan(json5, parser->pos + 1, len, CJ5__SCAN_BLANK, 0) - 1;
+            }
+            CJ5__STAT(r->stats.bytes_whitespace += parser->pos + 1 - stat_pos;)
+            break;
+
+        case ':':
+            parser->can_comment = false;
+            if (parser->chunk) {
+                cj5__chunk_mark(parser, parser->pos);
+                break;
+            }
+            parser->super_id = parser->next_id - 1;
+            break;
+
+        case ',':
+            parser->can_comment = false;
+            if (parser->chunk) {
+                cj5__chunk_mark(parser, parser->pos);
+                break;
+            }
+            cj5__comma(parser);
+            break;
+        case '/':
+            if (parser->can_comment && parser->pos < len - 1) {
+                CJ5__STAT(stat_pos = parser->pos; stat_clock = CJ5__STAT_CLOCK();)
+                if (json5[parser->pos + 1] == '/') {
+                    cj5__skip_comment(parser, json5, len);
+                    CJ5__STAT(r->stats.bytes_comments += parser->pos - stat_pos;
+                              r->stats.cycles_comments += CJ5__STAT_CLOCK() - stat_clock;)
+                    if (parser->pos == len && !final) {
+                        cj5__suspend_comment(parser, json5, len, CJ5__PENDING_COMMENT);
+                        return;
+                    }
+                } else if (json5[parser->pos + 1] == '*') {
+                    cj5__skip_multiline_comment(parser, json5, len);
+                    // stops at the '*' of "*/"
+                    CJ5__STAT(r->stats.bytes_comments +=
+                              (parser->pos < len ? parser->pos + 2 : len) - stat_pos;
+                              r->stats.cycles_comments += CJ5__STAT_CLOCK() - stat_clock;)
+                    if (parser->pos == len && !final) {
+                        cj5__suspend_comment(parser, json5, len, CJ5__PENDING_MULTILINE_COMMENT);
+                        return;
+                    }
+                }
+            } else if (parser->can_comment && !final) {
+                // need the next character to see if it's a comment
+                parser->pending = CJ5__PENDING_DATA;
+                return;
+            }
+            break;
+
+        default:
+            CJ5__STAT(stat_pos = parser->pos; stat_clock = CJ5__STAT_CLOCK();)
+            cj5__parse_primitive(parser, json5, len, final);
+            CJ5__STAT(r->stats.cycles_primitives += CJ5__STAT_CLOCK() - stat_clock;)
+            if ((r->error && r->error != CJ5_ERROR_OVERFLOW) || parser->pending) {
+                return;
+            }
+            CJ5__STAT(cj5__stats_primitive(parser, json5, stat_pos, parser->pos + 1, len);)
+            parser->can_comment = false;
+            parser->num_tokens++;
+            cj5__add_child(parser, json5);
+            break;
+        }
+    }
+
+}
+
+void cj5_parser_init(cj5_parser* parser, cj5_token* tokens, cj5_int max_tokens)
+{
+    CJ5_MEMSET(parser, 0x0, sizeof(*parser));
+    parser->super_id = -1;
+    parser->tokens = tokens;
+    parser->max_tokens = max_tokens;
+}
+
+void cj5_parser_set_realloc(cj5_parser* parser, cj5_realloc_fn* realloc_fn, void* user)
+{
+    parser->realloc_fn = realloc_fn;
+    parser->realloc_user = user;
+}
+
+cj5_error_code cj5_parser_feed(cj5_parser* parser, const char* json5, cj5_int len)
+{
+    if (!parser->result.error || parser->result.error == CJ5_ERROR_OVERFLOW) {
+        CJ5__STAT(uint64_t start = CJ5__STAT_CLOCK();)
+        cj5__parse_run(parser, json5, len, len, false);
+        CJ5__STAT(parser->result.stats.cycles_total += CJ5__STAT_CLOCK() - start;)
+    }
+    return parser->result.error;
+}
+
+cj5_result cj5_parser_finish(cj5_parser* parser, const char* json5, cj5_int len)
+{
+    if (!parser->result.error || parser->result.error == CJ5_ERROR_OVERFLOW) {
+        CJ5__STAT(uint64_t start = CJ5__STAT_CLOCK();)
+        cj5__parse_run(parser, json5, len, len, true);
+        CJ5__STAT(parser->result.stats.cycles_total += CJ5__STAT_CLOCK() - start;)
+    }
+
+    cj5_result r = parser->result;
+    if (parser->realloc_fn) {
+        // grown memory is owned by the caller, even if there is an error
+        r.tokens = parser->tokens;
+    }
+    if (r.error && r.error != CJ5_ERROR_OVERFLOW) {
+        return r;
+    }
+
+    if (parser->tokens && r.error != CJ5_ERROR_OVERFLOW) {
+        for (cj5_int i = parser->next_id - 1; i >= 0; i--) {
+            // unmatched object or array ?
+            if (parser->tokens[i].start != -1 && parser->tokens[i].end == -1) {
+                cj5__set_error(&r, CJ5_ERROR_INCOMPLETE, parser->line, parser->pos - parser->line);
                 return r;
             }
-            count++;
-            if (parser.super_id != -1 && tokens && r.error != CJ5_ERROR_OVERFLOW) {
-                if (++tokens[parser.super_id].size == 1 &&
-                    tokens[parser.super_id].type == CJ5_TOKEN_STRING) {
-                    // it's not a value, it's a key, so hash it
-                    tokens[parser.super_id].key_hash = cj5__hash_fnv32(
-                        &json5[tokens[parser.super_id].start], &json5[tokens[parser.super_id].end]);
-                    tokens[parser.super_id].key_start = tokens[parser.super_id].start;
-                    tokens[parser.super_id].key_end = tokens[parser.super_id].end;
+        }
+
+        // close the children of the last token's parents (top-level keys without a container)
+        for (cj5_int i = parser->next_id - 1; i != -1; i = parser->tokens[i].parent_id) {
+            parser->tokens[i].next_id = parser->next_id;
+        }
+    }
+
+    r.num_tokens = parser->num_tokens;
+    r.tokens = parser->tokens;
+    r.json5 = json5;
+    return r;
+}
+
+cj5_result cj5_parse(const char* json5, cj5_int len, cj5_token* tokens, cj5_int max_tokens)
+{
+    cj5_parser parser;
+    cj5_parser_init(&parser, tokens, max_tokens);
+    return cj5_parser_finish(&parser, json5, len);
+}
+
+cj5_result cj5_parse_realloc(const char* json5, cj5_int len, cj5_token* tokens, cj5_int max_tokens,
+                             cj5_realloc_fn* realloc_fn, void* user)
+{
+    cj5_parser parser;
+    cj5_parser_init(&parser, tokens, tokens ? max_tokens : 0);
+    cj5_parser_set_realloc(&parser, realloc_fn, user);
+    return cj5_parser_finish(&parser, json5, len);
+}
+
+// validation: the last token and its parents, one bit per level in each stack. the first `super`
+// levels are the parents of the next token, like `super_id` of the parser. containers that are
+// still open are always inside of those, and the innermost one is the one that '}' or ']' closes
+typedef struct cj5__validator {
+    uint64_t container[(CJ5_VALIDATE_MAX_DEPTH + 63) / 64];
+    uint64_t object[(CJ5_VALIDATE_MAX_DEPTH + 63) / 64];
+    uint64_t open[(CJ5_VALIDATE_MAX_DEPTH + 63) / 64];
+    cj5_int depth;
+    cj5_int super;
+    cj5_int num_open;
+} cj5__validator;
+
+static inline bool cj5__bit_get(const uint64_t* bits, cj5_int i)
+{
+    return (bits[i >> 6] >> (i & 63)) & 1;
+}
+
+static inline void cj5__bit_put(uint64_t* bits, cj5_int i, bool value)
+{
+    uint64_t mask = 1ull << (i & 63);
+    bits[i >> 6] = value ? (bits[i >> 6] | mask) : (bits[i >> 6] & ~mask);
+}
+
+// adds a token as the child of the current super level
+static bool cj5__validate_push(cj5__validator* v, bool container, bool object)
+{
+    if (v->super == CJ5_VALIDATE_MAX_DEPTH) {
+        return false;
+    }
+    v->depth = v->super;
+    cj5__bit_put(v->container, v->depth, container);
+    cj5__bit_put(v->object, v->depth, object);
+    cj5__bit_put(v->open, v->depth, container);
+    v->depth++;
+    if (container) {
+        v->super = v->depth;
+        v->num_open++;
+    }
+    return true;
+}
+
+// same checks as `cj5__close`
+static bool cj5__validate_close(cj5_parser* parser, cj5__validator* v, char c)
+{
+    cj5_result* r = &parser->result;
+    bool object = c == '}';
+    if (v->depth == 0) {
+        cj5__set_error(r, CJ5_ERROR_INVALID, parser->line, parser->pos - parser->line);
+        return false;
+    }
+
+    if (v->num_open == 0) {
+        // the walk reaches the first token
+        if (!cj5__bit_get(v->container, 0) || cj5__bit_get(v->object, 0) != object ||
+            v->super == 0) {
+            cj5__set_error(r, CJ5_ERROR_INVALID, parser->line, parser->pos - parser->line);
+            return false;
+        }
+        return true;
+    }
+
+    cj5_int w = (v->depth - 1) >> 6;
+    while (v->open[w] == 0) {
+        w--;
+    }
+    cj5_int level = w * 64 + 63 - cj5__clz64(v->open[w]);
+    if (cj5__bit_get(v->object, level) != object) {
+        cj5__set_error(r, CJ5_ERROR_INVALID, parser->line, parser->pos - parser->line);
+        return false;
+    }
+    cj5__bit_put(v->open, level, false);
+    v->num_open--;
+    v->super = level;
+    return true;
+}
+
+// first character of the class in json5[pos..len), values are short, so the first few characters
+// are checked one by one before the SIMD scanner
+static inline cj5_int cj5__validate_scan(const char* json5, cj5_int pos, cj5_int len,
+                                         cj5__scan_class cls, char ch)
+{
+    cj5_int stop = pos + 16 < len ? pos + 16 : len;
+    for (; pos < stop; pos++) {
+        if (cj5__scan_match(json5[pos], cls, ch)) {
+            return pos;
+        }
+    }
+    return cj5__scan(json5, pos, len, cls, ch);
+}
+
+// `cj5__parse_string` without the token, same errors. on success, `pos` is at the closing quote
+static bool cj5__validate_string(cj5_parser* parser, const char* json5, cj5_int len)
+{
+    cj5_result* r = &parser->result;
+    cj5_int line_start = parser->pos;
+    char str_open = json5[parser->pos];
+    cj5_int pos = parser->pos + 1;
+    for (; pos < len; pos++) {
+        pos = cj5__validate_scan(json5, pos, len, CJ5__SCAN_STRING, str_open);
+        if (pos == len) {
+            break;
+        } else if (json5[pos] == str_open) {
+            parser->pos = pos;
+            return true;
+        } else if (pos + 1 == len) {
+            continue;
+        }
+
+        switch (json5[++pos]) {
+        case '\"':
+        case '\'':
+        case '/':
+        case '\\':
+        case 'b':
+        case 'f':
+        case 'r':
+        case 'n':
+        case 't':
+            break;
+        case 'u':
+            ++pos;
+            for (int i = 0; i < 4 && pos < len; i++, pos++) {
+                if (!(cj5__isrange(json5[pos], '0', '9') || cj5__isrange(json5[pos], 'A', 'F') ||
+                      cj5__isrange(json5[pos], 'a', 'f'))) {
+                    cj5__set_error(r, CJ5_ERROR_INVALID, parser->line, pos - line_start);
+                    return false;
                 }
             }
+            --pos;
+            break;
+        case '\n':
+            line_start = pos;
+            ++parser->line;
+            break;
+        default:
+            cj5__set_error(r, CJ5_ERROR_INVALID, parser->line, pos - line_start);
+            return false;
+        }
+    }
+
+    cj5__set_error(r, CJ5_ERROR_INCOMPLETE, parser->line, pos - line_start);
+    return false;
+}
+
+static inline cj5_int cj5__validate_digits(const char* json5, cj5_int pos, cj5_int len)
+{
+    while (pos < len && cj5__isnum(json5[pos])) {
+        pos++;
+    }
+    return pos;
+}
+
+static inline bool cj5__validate_terminator(char c)
+{
+    return c == '\n' || c == ':' || c == '\t' || c == '\r' || c == ' ' || c == ',' || c == ']' ||
+           c == '}';
+}
+
+// `cj5__parse_primitive` without the token, same errors. on success, `pos` is at the last character
+static bool cj5__validate_primitive(cj5_parser* parser, const char* json5, cj5_int len)
+{
+    cj5_result* r = &parser->result;
+    cj5_int start = parser->pos;
+
+    // plain numbers like -12.5e3 are valid as they are, anything else goes the long way
+    cj5_int pos = start + (json5[start] == '-');
+    cj5_int digits = cj5__validate_digits(json5, pos, len);
+    if (digits > pos) {
+        pos = digits;
+        if (pos < len && json5[pos] == '.') {
+            pos = cj5__validate_digits(json5, pos + 1, len);
+        }
+        if (pos < len && (json5[pos] == 'e' || json5[pos] == 'E')) {
+            cj5_int exp = pos + 1;
+            if (exp < len && (json5[exp] == '+' || json5[exp] == '-')) {
+                exp++;
+            }
+            pos = cj5__validate_digits(json5, exp, len);
+            pos = pos > exp ? pos : len;
+        }
+        if (pos < len && json5[pos] != ':' && cj5__validate_terminator(json5[pos])) {
+            if (json5[pos] == '\n') {
+                ++parser->line;
+            }
+            parser->pos = pos - 1;
+            return true;
+        }
+    } else if (json5[start] == '_' || cj5__islowerchar(json5[start]) ||
+               cj5__isupperchar(json5[start])) {
+        // keys without quotes
+        pos = start + 1;
+        while (pos < len && (json5[pos] == '_' || cj5__islowerchar(json5[pos]) ||
+                             cj5__isupperchar(json5[pos]) || cj5__isnum(json5[pos]))) {
+            pos++;
+        }
+        if (pos < len && json5[pos] == ':') {
+            parser->pos = pos - 1;
+            return true;
+        }
+    }
+
+    pos = cj5__validate_scan(json5, start, len, CJ5__SCAN_PRIMITIVE, 0);
+    if (pos == len) {
+        cj5__set_error(r, CJ5_ERROR_INCOMPLETE, parser->line, pos - start);
+        return false;
+    }
+
+    char c = json5[pos];
+    if (!cj5__validate_terminator(c)) {
+        // control or non-ASCII character
+        cj5__set_error(r, CJ5_ERROR_INVALID, parser->line, pos - start);
+        return false;
+    }
+
+    cj5_token_number_type num_type;
+    cj5_int type_start = start;
+    if (cj5__primitive_type(json5, &type_start, pos, c == ':', &num_type) < 0) {
+        // errors are at the end of the primitive, or the start of the next line
+        cj5__set_error(r, CJ5_ERROR_INVALID, parser->line, c == '\n' ? 0 : pos - start);
+        return false;
+    }
+
+    if (c == '\n') {
+        ++parser->line;
+    }
+    parser->pos = pos - 1;
+    return true;
+}
+
+cj5_result cj5_validate(const char* json5, cj5_int len)
+{
+    cj5_parser parser;
+    cj5_parser_init(&parser, NULL, 0);
+    cj5_result* r = &parser.result;
+
+    cj5__validator v;
+    CJ5_MEMSET(&v, 0x0, sizeof(v));
+
+    cj5_int num_tokens = 0;
+    for (; parser.pos < len; parser.pos++) {
+        char c = json5[parser.pos];
+        switch (c) {
+        case '{':
+        case '[':
+            parser.can_comment = false;
+            if (!cj5__validate_push(&v, true, c == '{')) {
+                r->error = CJ5_ERROR_OVERFLOW;
+                return *r;
+            }
+            num_tokens++;
+            break;
+
+        case '}':
+        case ']':
+            parser.can_comment = false;
+            if (!cj5__validate_close(&parser, &v, c)) {
+                return *r;
+            }
+            break;
+
+        case '\"':
+        case '\'':
+            parser.can_comment = false;
+            if (!cj5__validate_string(&parser, json5, len)) {
+                return *r;
+            }
+            if (!cj5__validate_push(&v, false, false)) {
+                r->error = CJ5_ERROR_OVERFLOW;
+                return *r;
+            }
+            num_tokens++;
             break;
 
         case '\r':
-            can_comment = true;
+            parser.can_comment = true;
             break;
         case '\n':
             ++parser.line;
-            can_comment = true;
+            parser.can_comment = true;
             break;
         case '\t':
         case ' ':
+            if (parser.pos + 1 < len &&
+                (json5[parser.pos + 1] == ' ' || json5[parser.pos + 1] == '\t')) {
+                parser.pos = cj5__validate_scan(json5, parser.pos + 1, len, CJ5__SCAN_BLANK, 0) - 1;
+            }
             break;
 
         case ':':
-            can_comment = false;
-            parser.super_id = parser.next_id - 1;
+            parser.can_comment = false;
+            v.super = v.depth;
             break;
 
         case ',':
-            can_comment = false;
-            if (tokens != NULL && parser.super_id != -1 && r.error != CJ5_ERROR_OVERFLOW &&
-                tokens[parser.super_id].type != CJ5_TOKEN_ARRAY &&
-                tokens[parser.super_id].type != CJ5_TOKEN_OBJECT) {
-                parser.super_id = tokens[parser.super_id].parent_id;
+            parser.can_comment = false;
+            // keys and other values are done, containers stay open until their bracket
+            if (v.super > 0 && !cj5__bit_get(v.container, v.super - 1)) {
+                v.super--;
             }
             break;
+
         case '/':
-            if (can_comment && parser.pos < len - 1) {
+            if (parser.can_comment && parser.pos < len - 1) {
                 if (json5[parser.pos + 1] == '/') {
                     cj5__skip_comment(&parser, json5, len);
                 } else if (json5[parser.pos + 1] == '*') {
                     cj5__skip_multiline_comment(&parser, json5, len);
                 }
-            } 
+            }
             break;
 
         default:
-            cj5__parse_primitive(&parser, &r, json5, len, tokens, max_tokens);
-            if (r.error && r.error != CJ5_ERROR_OVERFLOW) {
-                return r;
+            if (!cj5__validate_primitive(&parser, json5, len)) {
+                return *r;
             }
-            can_comment = false;
-            count++;
-            if (parser.super_id != -1 && tokens && r.error != CJ5_ERROR_OVERFLOW) {
-                if (++tokens[parser.super_id].size == 1 &&
-                    tokens[parser.super_id].type == CJ5_TOKEN_STRING) {
-                    tokens[parser.super_id].key_hash = cj5__hash_fnv32(
-                        &json5[tokens[parser.super_id].start], &json5[tokens[parser.super_id].end]);
-                    tokens[parser.super_id].key_start = tokens[parser.super_id].start;
-                    tokens[parser.super_id].key_end = tokens[parser.super_id].end;
-                }
+            if (!cj5__validate_push(&v, false, false)) {
+                r->error = CJ5_ERROR_OVERFLOW;
+                return *r;
             }
+            parser.can_comment = false;
+            num_tokens++;
             break;
         }
     }
 
-    if (tokens && r.error != CJ5_ERROR_OVERFLOW) {
-        for (int i = parser.next_id - 1; i >= 0; i--) {
-            // unmatched object or array ?
-            if (tokens[i].start != -1 && tokens[i].end == -1) {
-                cj5__set_error(&r, CJ5_ERROR_INCOMPLETE, parser.line, parser.pos - parser.line);
-                return r;
-            }
+    if (v.num_open > 0) {
+        // unmatched object or array
+        cj5__set_error(r, CJ5_ERROR_INCOMPLETE, parser.line, parser.pos - parser.line);
+        return *r;
+    }
+
+    r->num_tokens = num_tokens;
+    r->json5 = json5;
+    return *r;
+}
+
+// token counting: a block of 64 bytes is classified at once, then only the characters that can
+// start or end a token are visited
+typedef struct cj5__count_block {
+    uint64_t structure;     // brackets, quotes and '/'
+    uint64_t separator;     // ':', ',', '\n' and '\r', they only matter for comments
+    uint64_t terminator;    // primitive terminators, see CJ5__SCAN_PRIMITIVE
+    uint64_t blank;         // ' ' and '\t'
+    uint64_t strings[2];    // closing quote or backslash, for '"' and '\'' strings
+    unsigned have_strings;  // bit i: strings[i] is computed, only blocks with strings need them
+} cj5__count_block;
+
+static inline uint64_t cj5__count_mask(const char* p, cj5__scan_class cls, char ch)
+{
+#    if CJ5__SIMD
+    return cj5__scan_mask(p, cls, ch);
+#    else
+    uint64_t mask = 0;
+    for (int i = 0; i < 64; i++) {
+        mask |= (uint64_t)cj5__scan_match(p[i], cls, ch) << i;
+    }
+    return mask;
+#    endif
+}
+
+static inline void cj5__count_classify(const char* p, cj5__count_block* b)
+{
+    b->structure = cj5__count_mask(p, CJ5__SCAN_STRUCTURE, 0);
+    b->separator = cj5__count_mask(p, CJ5__SCAN_LINE_END, 0) |
+                   cj5__count_mask(p, CJ5__SCAN_CHAR, ':') |
+                   cj5__count_mask(p, CJ5__SCAN_CHAR, ',');
+    b->terminator = cj5__count_mask(p, CJ5__SCAN_PRIMITIVE, 0);
+    b->blank = ~cj5__count_mask(p, CJ5__SCAN_BLANK, 0);
+    b->have_strings = 0;
+}
+
+// the parser allows a comment after a line end, until the next token, ':' or ','. separators are
+// not visited, so they are looked at backwards from the '/' to the last token or comment
+static inline bool cj5__count_can_comment(const char* json5, cj5_int pos, cj5_int token_end,
+                                          cj5_int comment_end)
+{
+    for (cj5_int k = pos - 1; k >= token_end && k >= comment_end; k--) {
+        if (json5[k] == '\n' || json5[k] == '\r') {
+            return true;
+        } else if (json5[k] == ':' || json5[k] == ',') {
+            return false;
         }
     }
+    // a comment leaves it allowed
+    return comment_end > token_end;
+}
 
-    r.num_tokens = count;
-    r.tokens = tokens;
-    r.json5 = json5;
-    return r;
+// closing quote of the string that starts after p[i], continues after the block if it's not in it
+static inline cj5_int cj5__count_string(const char* json5, cj5_int len, cj5_int base, const char* p,
+                                        cj5__count_block* b, cj5_int i, char ch)
+{
+    int q = ch == '\'';
+    if (!(b->have_strings & (1u << q))) {
+        b->strings[q] = cj5__count_mask(p, CJ5__SCAN_STRING, ch);
+        b->have_strings |= 1u << q;
+    }
+
+    // backslash, skip the escaped character
+    cj5_int j = i + 1;
+    uint64_t mask;
+    while (j < 64 && (mask = b->strings[q] >> j) != 0) {
+        j += cj5__ctz64(mask);
+        if (p[j] == ch) {
+            return base + j;
+        }
+        j += 2;
+    }
+
+    cj5_int end = cj5__scan(json5, base + j, len, CJ5__SCAN_STRING, ch);
+    while (end < len && json5[end] != ch) {
+        end = cj5__scan(json5, end + 2, len, CJ5__SCAN_STRING, ch);
+    }
+    return end;
+}
+
+cj5_int cj5_count_tokens(const char* json5, cj5_int len, cj5_int* max_depth, cj5_int* string_bytes)
+{
+    // same token boundaries and comment rules as `cj5__parse_run`
+    cj5_int num_tokens = 0;
+    cj5_int depth = 0;
+    cj5_int deepest = 0;
+    cj5_int num_string_bytes = 0;
+    cj5_int token_end = 0;
+    cj5_int comment_end = -1;
+    char tail[64];
+    cj5_int pos = 0;
+    while (pos < len) {
+        // the last block is padded with blanks, they don't start anything
+        cj5_int base = pos;
+        const char* p = &json5[base];
+        if (len - base < 64) {
+            CJ5_MEMCPY(tail, p, (size_t)(len - base));
+            CJ5_MEMSET(&tail[len - base], ' ', (size_t)(64 - (len - base)));
+            p = tail;
+        }
+
+        cj5__count_block b;
+        cj5__count_classify(p, &b);
+        uint64_t values = ~(b.structure | b.terminator | b.blank);
+        // structure, first characters of primitives and the other terminators, which the parser
+        // takes as primitives too. bit 0 always starts, the position before it is already done
+        uint64_t bits = b.structure | (values & ~(values << 1)) |
+                        (b.terminator & ~(b.structure | b.separator | b.blank));
+
+        pos = base + 64;
+        while (bits) {
+            cj5_int i = cj5__ctz64(bits);
+            cj5_int next = base + i + 1;    // where the next token can start
+            char ch = p[i];
+            switch (ch) {
+            case '{':
+            case '[':
+                num_tokens++;
+                deepest = ++depth > deepest ? depth : deepest;
+                token_end = next;
+                break;
+
+            case '}':
+            case ']':
+                depth -= depth > 0 ? 1 : 0;
+                token_end = next;
+                break;
+
+            case '\"':
+            case '\'': {
+                cj5_int end = cj5__count_string(json5, len, base, p, &b, i, ch);
+                num_string_bytes += end - base - i - 1;
+                num_tokens++;
+                token_end = next = end + 1;
+                break;
+            }
+
+            case '/':
+                if (next >= len || (json5[next] != '/' && json5[next] != '*') ||
+                    !cj5__count_can_comment(json5, base + i, token_end, comment_end)) {
+                    break;
+                }
+                if (json5[next] == '/') {
+                    // the line end is skipped with the comment
+                    next = cj5__scan(json5, next, len, CJ5__SCAN_LINE_END, 0) + 1;
+                } else if (json5[next] == '*') {
+                    // the parser stops at the '*' of "*/" (which can be the one of "/*" too), then
+                    // looks at the '/' again
+                    cj5_int star = base + i;
+                    do {
+                        star = cj5__scan(json5, star, len, CJ5__SCAN_CHAR, '*');
+                    } while (star < len - 1 && json5[star + 1] != '/' && ++star < len);
+                    next = star + 1;
+                }
+                comment_end = next;
+                break;
+
+            default: {
+                // primitive, the terminator is looked at next
+                uint64_t term = b.terminator >> i;
+                cj5_int end = term ? base + i + cj5__ctz64(term)
+                                   : cj5__scan(json5, base + 64, len, CJ5__SCAN_PRIMITIVE, 0);
+                if (end < len && json5[end] == ':') {
+                    num_string_bytes += end - base - i;
+                }
+                num_tokens++;
+                token_end = next = end > base + i ? end : next;
+                break;
+            }
+            }
+
+            if (next - base >= 64) {
+                pos = next;
+                break;
+            }
+            bits &= ~0ull << (next - base);
+        }
+    }
+
+    if (max_depth) {
+        *max_depth = deepest;
+    }
+    if (string_bytes) {
+        *string_bytes = num_string_bytes;
+    }
+    return num_tokens;
+}
+
+// returns the smallest object or array that has the edit strictly inside its brackets, or -1
+static cj5_int cj5__edit_container(const cj5_token* tokens, cj5_int num_tokens,
+                                   const cj5_edit* edit)
+{
+    cj5_int container = -1;
+    cj5_int i = 0;
+    cj5_int end = num_tokens;
+    while (i < end) {
+        const cj5_token* tok = &tokens[i];
+        if (tok->start > edit->end) {
+            break;
+        }
+
+        // keys: look at the value, their next_id skips both
+        cj5_int v = (tok->type == CJ5_TOKEN_STRING && tok->size == 1) ? i + 1 : i;
+        const cj5_token* val = &tokens[v];
+        if ((val->type == CJ5_TOKEN_OBJECT || val->type == CJ5_TOKEN_ARRAY) &&
+            val->start < edit->start && edit->end < val->end) {
+            container = v;
+            i = v + 1;
+            end = val->next_id;
+        } else {
+            i = tok->next_id;
+        }
+    }
+    return container;
+}
+
+cj5_result cj5_parse_edit(const char* json5, cj5_int len, cj5_token* tokens, cj5_int max_tokens,
+                          const cj5_result* prev, const cj5_edit* edit)
+{
+    cj5_int c = -1;
+    if (prev->error == CJ5_ERROR_NONE && prev->tokens == tokens && tokens) {
+        c = cj5__edit_container(tokens, prev->num_tokens, edit);
+    }
+    if (c == -1) {
+        return cj5_parse(json5, len, tokens, max_tokens);
+    }
+
+    const cj5_token old = tokens[c];
+    const cj5_int num_tokens = prev->num_tokens;
+    const cj5_int delta = edit->new_len - (edit->end - edit->start);
+    const cj5_int sub_len = old.end + delta - old.start;
+    const cj5_int old_count = old.next_id - c;
+    const cj5_int tail = num_tokens - old.next_id;
+
+    // a ':' after the container (like "[1]: 2") makes the next tokens children of the tokens in it,
+    // then the container can't be parsed on its own
+    if (tokens[old.next_id - 1].end > old.end ||
+        (tail > 0 && tokens[old.next_id].parent_id >= c &&
+         tokens[old.next_id].parent_id < old.next_id)) {
+        return cj5_parse(json5, len, tokens, max_tokens);
+    }
+
+    // try the old slots of the container first, so the tokens after it only move once
+    cj5_result sub = cj5_parse(&json5[old.start], sub_len, &tokens[c], old_count);
+    cj5_int count = sub.num_tokens;
+    if (sub.error == CJ5_ERROR_OVERFLOW && num_tokens - old_count + count <= max_tokens) {
+        CJ5_MEMMOVE(&tokens[c + count], &tokens[old.next_id], sizeof(cj5_token) * (size_t)tail);
+        sub = cj5_parse(&json5[old.start], sub_len, &tokens[c], count);
+    } else if (sub.error == CJ5_ERROR_NONE) {
+        CJ5_MEMMOVE(&tokens[c + count], &tokens[old.next_id], sizeof(cj5_token) * (size_t)tail);
+    }
+
+    // the edit changed the structure outside of the container (or didn't fit in `tokens`)
+    if (sub.error || count < 1 || tokens[c].type != old.type || tokens[c].end != sub_len ||
+        tokens[c].next_id != count) {
+        return cj5_parse(json5, len, tokens, max_tokens);
+    }
+
+    // container tokens: relative to the container
+    for (cj5_int i = c; i < c + count; i++) {
+        cj5_token* tok = &tokens[i];
+        tok->start += old.start;
+        tok->end += old.start;
+        if (tok->key_end != 0) {
+            tok->key_start += old.start;
+            tok->key_end += old.start;
+        }
+        tok->parent_id = i == c ? old.parent_id : tok->parent_id + c;
+        tok->next_id += c;
+    }
+
+    // tokens after the container: moved by the change in size and count
+    const cj5_int id_delta = count - old_count;
+    for (cj5_int i = c + count; i < num_tokens + id_delta; i++) {
+        cj5_token* tok = &tokens[i];
+        tok->start += delta;
+        tok->end += delta;
+        if (tok->key_end != 0) {
+            tok->key_start += delta;
+            tok->key_end += delta;
+        }
+        if (tok->parent_id >= old.next_id) {
+            tok->parent_id += id_delta;
+        }
+        tok->next_id += id_delta;
+    }
+
+    // parents of the container (and its key) contain the change
+    for (cj5_int i = old.parent_id; i != -1; i = tokens[i].parent_id) {
+        cj5_token* tok = &tokens[i];
+        tok->next_id += id_delta;
+        if (tok->end >= old.end) {
+            tok->end += delta;
+        }
+    }
+
+    cj5_result r = *prev;
+    r.num_tokens = num_tokens + id_delta;
+    r.json5 = json5;
+    r.index = NULL;
+    return r;
+}
+
+typedef struct cj5__marker {
+    cj5_int pos;         // position of ',', ':', '}' or ']'
+    cj5_int token_id;    // number of tokens in the chunk before it
+} cj5__marker;
+
+typedef struct cj5__chunk {
+    const char* json5;
+    cj5_int len;
+    cj5_int start;
+    cj5_int stop;
+    const cj5_parallel_desc* desc;
+    cj5_parser parser;
+    cj5__marker* markers;
+    cj5_int num_markers;
+    cj5_int max_markers;
+} cj5__chunk;
+
+static void cj5__chunk_mark(cj5_parser* parser, cj5_int pos)
+{
+    cj5__chunk* chunk = parser->chunk;
+    if (parser->result.error) {
+        return;
+    }
+
+    if (chunk->num_markers == chunk->max_markers) {
+        cj5_int max_markers = chunk->max_markers < 32 ? 64 : chunk->max_markers * 2;
+        cj5__marker* markers = (cj5__marker*)chunk->desc->realloc_fn(
+            chunk->markers, (size_t)max_markers * sizeof(cj5__marker), chunk->desc->realloc_user);
+        if (!markers || max_markers <= chunk->max_markers) {
+            parser->result.error = CJ5_ERROR_OVERFLOW;
+            return;
+        }
+        chunk->markers = markers;
+        chunk->max_markers = max_markers;
+    }
+
+    cj5__marker* marker = &chunk->markers[chunk->num_markers++];
+    marker->pos = pos;
+    marker->token_id = parser->next_id;
+}
+
+// starts over at `pos` with the same token array, cheaper than `cj5_parser_init` for many small parses
+static void cj5__parser_reset(cj5_parser* parser, cj5_int pos, bool can_comment)
+{
+    parser->pos = pos;
+    parser->next_id = 0;
+    parser->num_tokens = 0;
+    parser->super_id = -1;
+    parser->can_comment = can_comment;
+    parser->pending = CJ5__PENDING_NONE;
+    parser->result.error = CJ5_ERROR_NONE;
+}
+
+static void cj5__parse_chunk(cj5__chunk* chunk, cj5_int pos, bool can_comment)
+{
+    cj5__parser_reset(&chunk->parser, pos, can_comment);
+    chunk->num_markers = 0;
+    cj5__parse_run(&chunk->parser, chunk->json5, chunk->stop, chunk->len, true);
+}
+
+static void cj5__parse_chunk_task(void* data, int index)
+{
+    cj5__chunk* chunk = &((cj5__chunk*)data)[index];
+
+    // guess: the chunk starts outside of strings and comments, right after a new line or a comma
+    bool can_comment = index > 0 && chunk->json5[chunk->start - 1] == '\n';
+    cj5__parse_chunk(chunk, chunk->start, can_comment);
+}
+
+// applies the structure of the chunks to their tokens, like `cj5__parse_run` does while parsing
+static bool cj5__stitch_chunks(cj5_parser* parser, const char* json5, cj5__chunk* chunks,
+                               int num_chunks)
+{
+    for (int i = 0; i < num_chunks; i++) {
+        const cj5__chunk* chunk = &chunks[i];
+        cj5_int num_tokens = chunk->parser.next_id;
+        if (num_tokens > 0) {
+            CJ5_MEMCPY(&parser->tokens[parser->next_id], chunk->parser.tokens,
+                       (size_t)num_tokens * sizeof(cj5_token));
+        }
+
+        cj5_int m = 0;
+        for (cj5_int k = 0; k <= num_tokens; k++) {
+            for (; m < chunk->num_markers && chunk->markers[m].token_id == k; m++) {
+                cj5_int pos = chunk->markers[m].pos;
+                char c = json5[pos];
+                if (c == ',') {
+                    cj5__comma(parser);
+                } else if (c == ':') {
+                    parser->super_id = parser->next_id - 1;
+                } else if (!cj5__close(parser, c, pos)) {
+                    return false;
+                }
+            }
+            if (k == num_tokens) {
+                break;
+            }
+
+            cj5_int id = parser->next_id++;
+            cj5_token* token = &parser->tokens[id];
+            token->next_id = parser->next_id;
+            if (token->type == CJ5_TOKEN_OBJECT || token->type == CJ5_TOKEN_ARRAY) {
+                cj5__open(parser, id, json5);
+            } else {
+                token->parent_id = parser->super_id;
+                cj5__add_child(parser, json5);
+            }
+        }
+    }
+
+    parser->num_tokens = parser->next_id;
+    return true;
+}
+
+cj5_result cj5_parse_parallel(const char* json5, cj5_int len, cj5_token* tokens,
+                              cj5_int max_tokens, const cj5_parallel_desc* desc)
+{
+    int min_chunk_size = desc->min_chunk_size > 0 ? desc->min_chunk_size : (1 << 20);
+    int num_chunks =
+        desc->num_chunks < len / min_chunk_size ? desc->num_chunks : (int)(len / min_chunk_size);
+    cj5__chunk* chunks = NULL;
+    if (num_chunks > 1) {
+        chunks = (cj5__chunk*)desc->realloc_fn(NULL, (size_t)num_chunks * sizeof(cj5__chunk),
+                                               desc->realloc_user);
+    }
+    if (!chunks) {
+        return cj5_parse(json5, len, tokens, max_tokens);
+    }
+
+    // split at new lines or commas after evenly spaced positions
+    int n = 0;
+    for (cj5_int start = 0; start < len && n < num_chunks; n++) {
+        cj5_int stop = n == num_chunks - 1 ? len : (cj5_int)((int64_t)len * (n + 1) / num_chunks);
+        if (stop <= start) {
+            stop = start + 1;
+        }
+        while (stop < len && json5[stop - 1] != '\n' && json5[stop - 1] != ',') {
+            stop++;
+        }
+
+        cj5__chunk* chunk = &chunks[n];
+        CJ5_MEMSET(chunk, 0x0, sizeof(*chunk));
+        chunk->json5 = json5;
+        chunk->len = len;
+        chunk->start = start;
+        chunk->stop = stop;
+        chunk->desc = desc;
+        cj5_parser_init(&chunk->parser, NULL, 0);
+        cj5_parser_set_realloc(&chunk->parser, desc->realloc_fn, desc->realloc_user);
+        chunk->parser.chunk = chunk;
+        start = stop;
+    }
+
+    desc->dispatch_fn(cj5__parse_chunk_task, chunks, n, desc->dispatch_user);
+
+    // a guess is right if the previous chunk stopped exactly at the start of the chunk, with the
+    // same comment state, otherwise parse it again from where the previous one stopped
+    bool ok = true;
+    cj5_int num_tokens = 0;
+    for (int i = 0; i < n && ok; i++) {
+        cj5__chunk* chunk = &chunks[i];
+        if (i > 0) {
+            const cj5_parser* prev = &chunks[i - 1].parser;
+            bool can_comment = json5[chunk->start - 1] == '\n';
+            if (prev->pos != chunk->start || prev->can_comment != can_comment) {
+                cj5__parse_chunk(chunk, prev->pos, prev->can_comment);
+            }
+        }
+        ok = chunk->parser.result.error == CJ5_ERROR_NONE;
+        num_tokens += chunk->parser.next_id;
+    }
+
+    cj5_result r;
+    CJ5_MEMSET(&r, 0x0, sizeof(r));
+    if (ok && !tokens && num_tokens > 0) {
+        // only counting the tokens, `cj5_parse` doesn't check the structure in this case either
+        r.error = CJ5_ERROR_OVERFLOW;
+        r.num_tokens = num_tokens;
+        r.json5 = json5;
+    } else if (ok && num_tokens > max_tokens) {
+        // serial parser fills as many tokens as it can
+        ok = false;
+    } else if (ok) {
+        cj5_parser parser;
+        cj5_parser_init(&parser, tokens, max_tokens);
+        ok = cj5__stitch_chunks(&parser, json5, chunks, n);
+        if (ok) {
+            parser.pos = len;
+            r = cj5_parser_finish(&parser, json5, len);
+            ok = r.error == CJ5_ERROR_NONE;
+        }
+    }
+
+    for (int i = 0; i < n; i++) {
+        if (chunks[i].parser.tokens) {
+            desc->realloc_fn(chunks[i].parser.tokens, 0, desc->realloc_user);
+        }
+        if (chunks[i].markers) {
+            desc->realloc_fn(chunks[i].markers, 0, desc->realloc_user);
+        }
+    }
+    desc->realloc_fn(chunks, 0, desc->realloc_user);
+
+    // errors are reported by the serial parser, so they have the same line and column
+    return ok ? r : cj5_parse(json5, len, tokens, max_tokens);
+}
+
+// records of json5[start..stop), in parallel mode every piece has its own batch with growing arrays
+typedef struct cj5__record_batch {
+    const char* json5;
+    cj5_int start;
+    cj5_int stop;
+    cj5_token* tokens;
+    cj5_int max_tokens;
+    cj5_record* records;
+    cj5_int max_records;
+    cj5_realloc_fn* realloc_fn;     // NULL: fixed size arrays
+    void* realloc_user;
+    cj5_parser parser;
+    cj5_records_result r;
+} cj5__record_batch;
+
+static void* cj5__grow_array(cj5__record_batch* b, void* ptr, cj5_int* max_items, cj5_int num_items,
+                             size_t item_size)
+{
+    cj5_int max_new = *max_items < 32 ? 64 : *max_items * 2;
+    if (max_new < num_items) {
+        max_new = num_items;
+    }
+    if (max_new <= *max_items) {
+        return NULL;
+    }
+
+    void* p = b->realloc_fn(ptr, (size_t)max_new * item_size, b->realloc_user);
+    if (p) {
+        *max_items = max_new;
+    }
+    return p;
+}
+
+// parses one line json5[start..end), returns false if there are no tokens in it. `len` includes the
+// line break, so a primitive at the end of the line is terminated like in a document
+static bool cj5__parse_record(cj5__record_batch* b, cj5_int start, cj5_int end, cj5_int len,
+                              cj5_record* rec)
+{
+    cj5_records_result* r = &b->r;
+    cj5_parser* parser = &b->parser;
+    cj5_result pr;
+
+    for (;;) {
+        // after an overflow, only count what is needed like `cj5_parse`
+        bool fits = b->tokens && r->error != CJ5_ERROR_OVERFLOW;
+        cj5__parser_reset(parser, start, true);
+        parser->tokens = fits ? b->tokens + r->num_tokens : NULL;
+        parser->max_tokens = fits ? b->max_tokens - r->num_tokens : 0;
+        cj5__parse_run(parser, b->json5, end, len, true);
+        pr = cj5_parser_finish(parser, b->json5, end);
+        if (pr.error != CJ5_ERROR_OVERFLOW || !fits || !b->realloc_fn) {
+            break;
+        }
+
+        // parse the line again with enough space, only the line is lost
+        cj5_token* tokens = (cj5_token*)cj5__grow_array(b, b->tokens, &b->max_tokens,
+                                                        r->num_tokens + pr.num_tokens,
+                                                        sizeof(cj5_token));
+        if (!tokens) {
+            break;
+        }
+        b->tokens = tokens;
+    }
+
+    if (pr.num_tokens == 0 && pr.error == CJ5_ERROR_NONE) {
+        return false;
+    }
+
+    rec->token_begin = r->num_tokens;
+    rec->token_count = 0;
+    rec->start = start;
+    rec->end = end;
+    rec->error = pr.error;
+    if (pr.error == CJ5_ERROR_INVALID || pr.error == CJ5_ERROR_INCOMPLETE) {
+        if (r->num_invalid++ == 0 && r->error == CJ5_ERROR_NONE) {
+            r->error = pr.error;
+        }
+    } else {
+        rec->token_count = pr.num_tokens;
+        r->num_tokens += pr.num_tokens;
+        if (pr.error == CJ5_ERROR_OVERFLOW) {
+            r->error = CJ5_ERROR_OVERFLOW;
+        }
+    }
+    return true;
+}
+
+static void cj5__parse_lines(cj5__record_batch* b)
+{
+    cj5_records_result* r = &b->r;
+    const char* json5 = b->json5;
+    cj5_int pos = b->start;
+
+    while (pos < b->stop) {
+        cj5_int end = cj5__scan(json5, pos, b->stop, CJ5__SCAN_CHAR, '\n');
+        cj5_int line_end = (end > pos && json5[end - 1] == '\r') ? end - 1 : end;
+        cj5_record rec;
+        if (cj5__parse_record(b, pos, line_end, end < b->stop ? end + 1 : end, &rec)) {
+            if (r->num_records == b->max_records && b->realloc_fn && r->error != CJ5_ERROR_OVERFLOW) {
+                cj5_record* records = (cj5_record*)cj5__grow_array(
+                    b, b->records, &b->max_records, r->num_records + 1, sizeof(cj5_record));
+                if (records) {
+                    b->records = records;
+                }
+            }
+
+            if (r->num_records < b->max_records && b->records) {
+                b->records[r->num_records] = rec;
+            } else {
+                r->error = CJ5_ERROR_OVERFLOW;
+            }
+            r->num_records++;
+        }
+        pos = end + 1;
+    }
+}
+
+static void cj5__init_record_batch(cj5__record_batch* b, const char* json5, cj5_int start,
+                                   cj5_int stop)
+{
+    CJ5_MEMSET(b, 0x0, sizeof(*b));
+    b->json5 = json5;
+    b->start = start;
+    b->stop = stop;
+    cj5_parser_init(&b->parser, NULL, 0);
+}
+
+cj5_records_result cj5_parse_records(const char* json5, cj5_int len, cj5_token* tokens,
+                                     cj5_int max_tokens, cj5_record* records, cj5_int max_records)
+{
+    cj5__record_batch b;
+    cj5__init_record_batch(&b, json5, 0, len);
+    b.tokens = tokens;
+    b.max_tokens = tokens ? max_tokens : 0;
+    b.records = records;
+    b.max_records = records ? max_records : 0;
+    cj5__parse_lines(&b);
+
+    b.r.records = records;
+    b.r.tokens = tokens;
+    b.r.json5 = json5;
+    return b.r;
+}
+
+static void cj5__parse_records_task(void* data, int index)
+{
+    cj5__parse_lines(&((cj5__record_batch*)data)[index]);
+}
+
+cj5_records_result cj5_parse_records_parallel(const char* json5, cj5_int len, cj5_token* tokens,
+                                              cj5_int max_tokens, cj5_record* records,
+                                              cj5_int max_records, const cj5_parallel_desc* desc)
+{
+    int min_chunk_size = desc->min_chunk_size > 0 ? desc->min_chunk_size : (1 << 20);
+    int num_chunks =
+        desc->num_chunks < len / min_chunk_size ? desc->num_chunks : (int)(len / min_chunk_size);
+    cj5__record_batch* batches = NULL;
+    if (num_chunks > 1 && tokens && records) {
+        batches = (cj5__record_batch*)desc->realloc_fn(
+            NULL, (size_t)num_chunks * sizeof(cj5__record_batch), desc->realloc_user);
+    }
+    if (!batches) {
+        return cj5_parse_records(json5, len, tokens, max_tokens, records, max_records);
+    }
+
+    // unlike `cj5_parse_parallel`, the pieces always start at the beginning of a line
+    int n = 0;
+    for (cj5_int start = 0; start < len && n < num_chunks; n++) {
+        cj5_int stop = n == num_chunks - 1 ? len : (cj5_int)((int64_t)len * (n + 1) / num_chunks);
+        if (stop <= start) {
+            stop = start;
+        }
+        stop = cj5__scan(json5, stop, len, CJ5__SCAN_CHAR, '\n');
+        stop = stop < len ? stop + 1 : len;
+
+        cj5__record_batch* b = &batches[n];
+        cj5__init_record_batch(b, json5, start, stop);
+        b->realloc_fn = desc->realloc_fn;
+        b->realloc_user = desc->realloc_user;
+        start = stop;
+    }
+
+    desc->dispatch_fn(cj5__parse_records_task, batches, n, desc->dispatch_user);
+
+    cj5_int num_tokens = 0;
+    cj5_int num_records = 0;
+    bool ok = true;
+    for (int i = 0; i < n; i++) {
+        ok = ok && batches[i].r.error != CJ5_ERROR_OVERFLOW;
+        num_tokens += batches[i].r.num_tokens;
+        num_records += batches[i].r.num_records;
+    }
+
+    cj5_records_result r;
+    CJ5_MEMSET(&r, 0x0, sizeof(r));
+    if (ok && num_tokens <= max_tokens && num_records <= max_records) {
+        for (int i = 0; i < n; i++) {
+            const cj5__record_batch* b = &batches[i];
+            if (b->r.num_tokens > 0) {
+                CJ5_MEMCPY(&tokens[r.num_tokens], b->tokens, (size_t)b->r.num_tokens * sizeof(cj5_token));
+            }
+            for (cj5_int k = 0; k < b->r.num_records; k++) {
+                cj5_record* rec = &records[r.num_records + k];
+                *rec = b->records[k];
+                rec->token_begin += r.num_tokens;
+            }
+
+            if (r.error == CJ5_ERROR_NONE) {
+                r.error = b->r.error;
+            }
+            r.num_tokens += b->r.num_tokens;
+            r.num_records += b->r.num_records;
+            r.num_invalid += b->r.num_invalid;
+        }
+        r.records = records;
+        r.tokens = tokens;
+        r.json5 = json5;
+    } else {
+        ok = false;
+    }
+
+    for (int i = 0; i < n; i++) {
+        if (batches[i].tokens) {
+            desc->realloc_fn(batches[i].tokens, 0, desc->realloc_user);
+        }
+        if (batches[i].records) {
+            desc->realloc_fn(batches[i].records, 0, desc->realloc_user);
+        }
+    }
+    desc->realloc_fn(batches, 0, desc->realloc_user);
+
+    return ok ? r : cj5_parse_records(json5, len, tokens, max_tokens, records, max_records);
+}
+
+cj5_result cj5_get_record(const cj5_records_result* rs, cj5_int index)
+{
+    const cj5_record* rec = &rs->records[index];
+    cj5_result r;
+    CJ5_MEMSET(&r, 0x0, sizeof(r));
+    r.error = rec->error;
+    r.num_tokens = rec->token_count;
+    r.tokens = rec->error == CJ5_ERROR_NONE ? &rs->tokens[rec->token_begin] : NULL;
+    r.json5 = rs->json5;
+    return r;
+}
+
+#    if CJ5_MMAP
+#        include <fcntl.h>       // open
+#        include <sys/mman.h>    // mmap, posix_madvise
+#        include <sys/stat.h>    // fstat
+#        include <unistd.h>      // close
+
+bool cj5_file_open(cj5_file* file, const char* filepath)
+{
+    CJ5_MEMSET(file, 0x0, sizeof(*file));
+    file->data = "";
+
+    int fd = open(filepath, O_RDONLY);
+    if (fd == -1) {
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) ||
+        (uint64_t)st.st_size > (CJ5_LARGE ? INT64_MAX : INT32_MAX)) {
+        close(fd);
+        return false;
+    }
+
+    // mmap doesn't take empty files
+    if (st.st_size > 0) {
+        void* data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            return false;
+        }
+#        ifdef POSIX_MADV_SEQUENTIAL
+        // read-ahead more aggressively, the parser goes through the file once from the start
+        posix_madvise(data, (size_t)st.st_size, POSIX_MADV_SEQUENTIAL);
+#        endif
+        file->data = (const char*)data;
+        file->size = (cj5_int)st.st_size;
+    }
+
+    // the mapping keeps the file alive
+    close(fd);
+    return true;
+}
+
+void cj5_file_close(cj5_file* file)
+{
+    if (file->size > 0) {
+        munmap((void*)file->data, (size_t)file->size);
+    }
+    file->data = "";
+    file->size = 0;
+}
+
+cj5_result cj5_parse_file(cj5_file* file, const char* filepath, cj5_token* tokens,
+                          cj5_int max_tokens)
+{
+    if (!cj5_file_open(file, filepath)) {
+        cj5_result r;
+        CJ5_MEMSET(&r, 0x0, sizeof(r));
+        r.error = CJ5_ERROR_FILE;
+        return r;
+    }
+
+    // the parser never reads past `len`, even the 4 byte keyword compares of primitives, so the end
+    // of the mapping needs no padding when the file size is a multiple of the page size
+    return cj5_parse(file->data, file->size, tokens, max_tokens);
+}
+#    endif    // CJ5_MMAP
+
+static inline int cj5__hexval(char ch)
+{
+    if (cj5__isnum(ch)) {
+        return ch - '0';
+    } else if (cj5__isrange(ch, 'a', 'f')) {
+        return ch - 'a' + 10;
+    } else if (cj5__isrange(ch, 'A', 'F')) {
+        return ch - 'A' + 10;
+    }
+    return -1;
+}
+
+// reads the XXXX part of \uXXXX, returns -1 if it's not 4 hex digits
+static int cj5__hex4(const char* str, const char* end)
+{
+    if (end - str < 4) {
+        return -1;
+    }
+
+    int cp = 0;
+    for (int i = 0; i < 4; i++) {
+        int v = cj5__hexval(str[i]);
+        if (v < 0) {
+            return -1;
+        }
+        cp = (cp << 4) | v;
+    }
+    return cp;
+}
+
+static int cj5__utf8_encode(char* out, uint32_t cp)
+{
+    if (cp < 0x80) {
+        out[0] = (char)cp;
+        return 1;
+    } else if (cp < 0x800) {
+        out[0] = (char)(0xC0 | (cp >> 6));
+        out[1] = (char)(0x80 | (cp & 0x3F));
+        return 2;
+    } else if (cp < 0x10000) {
+        out[0] = (char)(0xE0 | (cp >> 12));
+        out[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (cp & 0x3F));
+        return 3;
+    } else {
+        out[0] = (char)(0xF0 | (cp >> 18));
+        out[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+        out[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+        out[3] = (char)(0x80 | (cp & 0x3F));
+        return 4;
+    }
+}
+
+// decodes the escape sequence at src[pos] (backslash) into `out`, returns the position after it
+static cj5_int cj5__unescape_one(const char* src, cj5_int pos, cj5_int len, char out[4], int* num_out)
+{
+    if (pos + 1 == len) {
+        // dangling backslash, keep it
+        out[0] = '\\';
+        *num_out = 1;
+        return len;
+    }
+
+    char c = src[pos + 1];
+    pos += 2;
+    *num_out = 1;
+    switch (c) {
+    case 'b':   out[0] = '\b';  break;
+    case 'f':   out[0] = '\f';  break;
+    case 'n':   out[0] = '\n';  break;
+    case 'r':   out[0] = '\r';  break;
+    case 't':   out[0] = '\t';  break;
+    case 'v':   out[0] = '\v';  break;
+    case '0':   out[0] = '\0';  break;
+    case '\r':
+        // line continuation, with windows line ending
+        if (pos < len && src[pos] == '\n') {
+            ++pos;
+        }
+        *num_out = 0;
+        break;
+    case '\n':
+        *num_out = 0;
+        break;
+    case 'u': {
+        int cp = cj5__hex4(&src[pos], &src[len]);
+        if (cp < 0) {
+            // not a valid escape, keep it as is
+            out[0] = 'u';
+            break;
+        }
+        pos += 4;
+
+        if (cp >= 0xD800 && cp <= 0xDBFF) {
+            // high surrogate, combine with the low surrogate that follows
+            int low = (len - pos >= 6 && src[pos] == '\\' && src[pos + 1] == 'u')
+                          ? cj5__hex4(&src[pos + 2], &src[len])
+                          : -1;
+            if (low >= 0xDC00 && low <= 0xDFFF) {
+                cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                pos += 6;
+            } else {
+                cp = 0xFFFD;
+            }
+        } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+            cp = 0xFFFD;
+        }
+        *num_out = cj5__utf8_encode(out, (uint32_t)cp);
+        break;
+    }
+    default:
+        // \", \', \\, \/ and the rest of characters escape to themselves
+        out[0] = c;
+        break;
+    }
+    return pos;
+}
+
+cj5_int cj5_unescape(char* dst, cj5_int max_dst, const char* src, cj5_int len)
+{
+    cj5_int pos = 0;
+    cj5_int num = 0;
+    while (pos < len && num < max_dst) {
+        // copy everything up to the next backslash in one go
+        cj5_int esc = cj5__scan(src, pos, len, CJ5__SCAN_CHAR, '\\');
+        cj5_int run = esc - pos;
+        if (run > max_dst - num) {
+            run = max_dst - num;
+        }
+        if (dst + num != src + pos) {
+            // decoding in place: destination is behind the source and can overlap it
+            CJ5_MEMMOVE(dst + num, src + pos, (size_t)run);
+        }
+        num += run;
+        pos += run;
+        if (pos < esc || esc == len) {
+            break;
+        }
+
+        char decoded[4];
+        int num_decoded;
+        pos = cj5__unescape_one(src, esc, len, decoded, &num_decoded);
+        if (num + num_decoded > max_dst) {
+            break;
+        }
+        for (int i = 0; i < num_decoded; i++) {
+            dst[num++] = decoded[i];
+        }
+    }
+
+    return num;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Compact token layout
+
+// the token fields that the helpers need, read from either layout
+typedef struct cj5__tok {
+    cj5_token_type type;
+    cj5_token_number_type num_type;
+    bool escaped;
+    bool key;           // string with a value
+    cj5_int start;
+    cj5_int end;
+    cj5_int next_id;
+} cj5__tok;
+
+static inline cj5__tok cj5__get_tok(const cj5_result* r, cj5_int id)
+{
+    CJ5_ASSERT(id >= 0 && id < r->num_tokens);
+    cj5__tok t;
+    if (r->compact) {
+        const cj5_compact_token* c = &r->compact[id];
+        t.type = CJ5_COMPACT_TYPE(c);
+        t.num_type = (cj5_token_number_type)((c->info >> CJ5_COMPACT_NUM_TYPE_SHIFT) & 0x3);
+        t.escaped = (c->info & CJ5_COMPACT_ESCAPED) != 0;
+        t.key = (c->info & CJ5_COMPACT_KEY) != 0;
+        t.start = (cj5_int)c->start;
+        t.end = (cj5_int)c->start + (cj5_int)c->len;
+        t.next_id = CJ5_COMPACT_NEXT_ID(c, id);
+    } else {
+        const cj5_token* tok = &r->tokens[id];
+        t.type = tok->type;
+        t.num_type = tok->type == CJ5_TOKEN_NUMBER ? tok->num_type : CJ5_TOKEN_NUMBER_UNKNOWN;
+        t.escaped = tok->escaped;
+        t.key = tok->size == 1 && tok->type == CJ5_TOKEN_STRING;
+        t.start = tok->start;
+        t.end = tok->end;
+        t.next_id = tok->next_id;
+    }
+    return t;
+}
+
+static inline cj5_int cj5__next(const cj5_result* r, cj5_int id)
+{
+    return r->compact ? CJ5_COMPACT_NEXT_ID(&r->compact[id], id) : r->tokens[id].next_id;
+}
+
+static inline bool cj5__is_key(const cj5_result* r, cj5_int id)
+{
+    if (r->compact) {
+        return (r->compact[id].info & CJ5_COMPACT_KEY) != 0;
+    }
+    return r->tokens[id].size == 1 && r->tokens[id].type == CJ5_TOKEN_STRING;
+}
+
+static inline uint32_t cj5__key_hash(const cj5_result* r, cj5_int id)
+{
+    return r->compact ? r->key_hashes[id] : r->tokens[id].key_hash;
+}
+
+static cj5_int cj5__parent(const cj5_result* r, cj5_int id)
+{
+    if (!r->compact) {
+        return r->tokens[id].parent_id;
+    }
+
+    uint32_t offset = r->compact[id].info >> CJ5_COMPACT_PARENT_SHIFT;
+    if (offset != CJ5_COMPACT_PARENT_FAR) {
+        return offset ? id - (cj5_int)offset : -1;
+    }
+
+    // the parent is the closest token before `id` with `id` in its subtree
+    for (cj5_int i = id - CJ5_COMPACT_PARENT_FAR; i >= 0; i--) {
+        if (cj5__next(r, i) > id) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static inline void cj5__compact_token(const cj5_token* tok, cj5_int id, cj5_compact_token* c,
+                                      uint32_t* key_hash)
+{
+    bool key = tok->size == 1 && tok->type == CJ5_TOKEN_STRING;
+    cj5_int parent_offset = tok->parent_id == -1 ? 0 : id - tok->parent_id;
+    if (parent_offset > CJ5_COMPACT_PARENT_FAR) {
+        parent_offset = CJ5_COMPACT_PARENT_FAR;
+    }
+
+    c->start = (uint32_t)tok->start;
+    c->len = (uint32_t)(tok->end - tok->start);
+    c->next = (uint32_t)(tok->next_id - id);
+    c->info = (uint32_t)tok->type |
+              (tok->type == CJ5_TOKEN_NUMBER ? (uint32_t)tok->num_type << CJ5_COMPACT_NUM_TYPE_SHIFT
+                                             : 0) |
+              (tok->escaped ? CJ5_COMPACT_ESCAPED : 0) | (key ? CJ5_COMPACT_KEY : 0) |
+              ((uint32_t)parent_offset << CJ5_COMPACT_PARENT_SHIFT);
+    *key_hash = key ? tok->key_hash : 0;
+}
+
+cj5_int cj5_compact(cj5_result* r, void* mem, cj5_int mem_size)
+{
+    const cj5_int n = r->num_tokens;
+    const cj5_int record_size = (cj5_int)(sizeof(cj5_compact_token) + sizeof(uint32_t));
+    if (r->tokens == NULL) {
+        return -1;
+    }
+#    if CJ5_LARGE
+    if (n > (cj5_int)UINT32_MAX) {
+        return -1;
+    }
+    for (cj5_int i = 0; i < n; i++) {
+        if (r->tokens[i].end > (cj5_int)UINT32_MAX) {
+            return -1;
+        }
+    }
+#    endif
+    if (mem == NULL || mem_size < n * record_size) {
+        return n * record_size;
+    }
+    CJ5_ASSERT(((uintptr_t)mem & (sizeof(uint32_t) - 1)) == 0);
+
+    cj5_compact_token* compact = (cj5_compact_token*)mem;
+    uint32_t* key_hashes = (uint32_t*)(compact + n);
+    if (mem != (const void*)r->tokens) {
+        for (cj5_int i = 0; i < n; i++) {
+            cj5__compact_token(&r->tokens[i], i, &compact[i], &key_hashes[i]);
+        }
+    } else {
+        // in place: tokens are larger than compact token + hash, so writing record i at 20*i never
+        // overwrites a token that isn't read yet. then the hashes are moved out of the way to
+        // [20n, 24n), the records are packed to 16*i and the hashes are moved back to 16*n
+        uint8_t* base = (uint8_t*)mem;
+        CJ5_ASSERT(sizeof(cj5_token) >= (size_t)record_size + sizeof(uint32_t));
+        for (cj5_int i = 0; i < n; i++) {
+            cj5_token tok = r->tokens[i];
+            cj5_compact_token c;
+            uint32_t key_hash;
+            cj5__compact_token(&tok, i, &c, &key_hash);
+            CJ5_MEMCPY(base + i * record_size, &c, sizeof(c));
+            CJ5_MEMCPY(base + i * record_size + sizeof(c), &key_hash, sizeof(key_hash));
+        }
+        uint32_t* tmp_hashes = (uint32_t*)(base + n * record_size);
+        for (cj5_int i = 0; i < n; i++) {
+            CJ5_MEMCPY(&tmp_hashes[i], base + i * record_size + sizeof(cj5_compact_token),
+                       sizeof(uint32_t));
+        }
+        for (cj5_int i = 0; i < n; i++) {
+            cj5_compact_token c;
+            CJ5_MEMCPY(&c, base + i * record_size, sizeof(c));
+            compact[i] = c;
+        }
+        for (cj5_int i = 0; i < n; i++) {
+            key_hashes[i] = tmp_hashes[i];
+        }
+    }
+
+    r->tokens = NULL;
+    r->compact = compact;
+    r->key_hashes = key_hashes;
+    return n * record_size;
+}
+
+cj5_token cj5_get_token(const cj5_result* r, cj5_int id)
+{
+    CJ5_ASSERT(id >= 0 && id < r->num_tokens);
+    if (!r->compact) {
+        return r->tokens[id];
+    }
+
+    cj5__tok t = cj5__get_tok(r, id);
+    cj5_token tok;
+    CJ5_MEMSET(&tok, 0x0, sizeof(tok));
+    tok.type = t.type;
+    if (t.key) {
+        tok.key_hash = r->key_hashes[id];
+    } else if (t.type == CJ5_TOKEN_NUMBER) {
+        tok.num_type = t.num_type;
+    }
+    tok.key_start = tok.start = t.start;
+    tok.key_end = tok.end = t.end;
+    for (cj5_int i = id + 1; i < t.next_id; i = cj5__next(r, i)) {
+        tok.size++;
+    }
+    tok.parent_id = cj5__parent(r, id);
+    tok.next_id = t.next_id;
+    tok.escaped = t.escaped;
+    return tok;
+}
+
+cj5_token_type cj5_get_type(const cj5_result* r, cj5_int id)
+{
+    CJ5_ASSERT(id >= 0 && id < r->num_tokens);
+    return r->compact ? CJ5_COMPACT_TYPE(&r->compact[id]) : r->tokens[id].type;
+}
+
+cj5_int cj5_get_next(const cj5_result* r, cj5_int id)
+{
+    CJ5_ASSERT(id >= 0 && id < r->num_tokens);
+    return cj5__next(r, id);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Token cache
+#    define CJ5__CACHE_MAGIC 0x54354a43    // "CJ5T"
+#    define CJ5__CACHE_VERSION 1
+
+typedef struct cj5__cache_header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t token_size;    // sizeof(cj5_token), 0 for the compact layout
+    uint32_t reserved;
+    uint64_t num_tokens;
+    uint64_t source_len;
+    uint64_t source_hash;
+    uint64_t tokens_hash;
+} cj5__cache_header;
+
+static inline uint64_t cj5__mix64(uint64_t a, uint64_t b)
+{
+    uint64_t hi;
+    uint64_t lo = cj5__mul128(a, b, &hi);
+    return lo ^ hi;
+}
+
+// fast 64-bit hash of a buffer, 16 bytes per multiply. not meant for hash tables or security,
+// only to see if a document has changed
+static uint64_t cj5__hash64(const void* data, cj5_int len)
+{
+    static const uint64_t k0 = 0xa0761d6478bd642fULL;
+    static const uint64_t k1 = 0xe7037ed1a0b428dbULL;
+    static const uint64_t k2 = 0x8ebc6af09c88c6e3ULL;
+    const uint8_t* p = (const uint8_t*)data;
+    uint64_t seed = k0 ^ (uint64_t)len;
+    uint64_t a, b;
+    cj5_int i = 0;
+    for (; i + 16 <= len; i += 16) {
+        CJ5_MEMCPY(&a, p + i, 8);
+        CJ5_MEMCPY(&b, p + i + 8, 8);
+        seed = cj5__mix64(a ^ k1, b ^ seed);
+    }
+
+    uint8_t tail[16];
+    CJ5_MEMSET(tail, 0x0, sizeof(tail));
+    if (i < len) {
+        CJ5_MEMCPY(tail, p + i, (size_t)(len - i));
+    }
+    CJ5_MEMCPY(&a, tail, 8);
+    CJ5_MEMCPY(&b, tail + 8, 8);
+    seed = cj5__mix64(a ^ k1, b ^ seed);
+    return cj5__mix64(seed ^ k2, (uint64_t)len ^ k1);
+}
+
+static inline cj5_int cj5__cache_tokens_size(cj5_int num_tokens, bool compact)
+{
+    return num_tokens * (compact ? (cj5_int)(sizeof(cj5_compact_token) + sizeof(uint32_t))
+                                 : (cj5_int)sizeof(cj5_token));
+}
+
+cj5_int cj5_save_tokens(const cj5_result* r, cj5_int len, void* mem, cj5_int mem_size)
+{
+    if (r->error) {
+        return -1;
+    }
+
+    bool compact = r->compact != NULL;
+    cj5_int tokens_size = cj5__cache_tokens_size(r->num_tokens, compact);
+    cj5_int size = (cj5_int)sizeof(cj5__cache_header) + tokens_size;
+    if (mem == NULL || mem_size < size) {
+        return size;
+    }
+
+    uint8_t* tokens = (uint8_t*)mem + sizeof(cj5__cache_header);
+    if (compact) {
+        cj5_int compact_size = r->num_tokens * (cj5_int)sizeof(cj5_compact_token);
+        CJ5_MEMCPY(tokens, r->compact, (size_t)compact_size);
+        CJ5_MEMCPY(tokens + compact_size, r->key_hashes,
+                   (size_t)r->num_tokens * sizeof(uint32_t));
+    } else {
+        CJ5_MEMCPY(tokens, r->tokens, (size_t)tokens_size);
+    }
+
+    cj5__cache_header header;
+    CJ5_MEMSET(&header, 0x0, sizeof(header));
+    header.magic = CJ5__CACHE_MAGIC;
+    header.version = CJ5__CACHE_VERSION;
+    header.token_size = compact ? 0 : (uint32_t)sizeof(cj5_token);
+    header.num_tokens = (uint64_t)r->num_tokens;
+    header.source_len = (uint64_t)len;
+    header.source_hash = cj5__hash64(r->json5, len);
+    header.tokens_hash = cj5__hash64(tokens, tokens_size);
+    CJ5_MEMCPY(mem, &header, sizeof(header));
+    return size;
+}
+
+cj5_result cj5_load_tokens(const void* blob, cj5_int blob_size, const char* json5, cj5_int len,
+                           bool verify)
+{
+    CJ5_ASSERT(((uintptr_t)blob & 7) == 0);
+    cj5_result r;
+    CJ5_MEMSET(&r, 0x0, sizeof(r));
+    r.error = CJ5_ERROR_CACHE;
+
+    const cj5__cache_header* header = (const cj5__cache_header*)blob;
+    if (blob_size < (cj5_int)sizeof(cj5__cache_header) || header->magic != CJ5__CACHE_MAGIC ||
+        header->version != CJ5__CACHE_VERSION ||
+        (header->token_size != 0 && header->token_size != (uint32_t)sizeof(cj5_token)) ||
+        header->source_len != (uint64_t)len) {
+        return r;
+    }
+
+    // token count and the blob size, without overflowing
+    bool compact = header->token_size == 0;
+    cj5_int max_tokens = (blob_size - (cj5_int)sizeof(cj5__cache_header)) /
+                         cj5__cache_tokens_size(1, compact);
+    if (header->num_tokens > (uint64_t)max_tokens) {
+        return r;
+    }
+
+    cj5_int num_tokens = (cj5_int)header->num_tokens;
+    const uint8_t* tokens = (const uint8_t*)blob + sizeof(cj5__cache_header);
+    if (verify &&
+        (header->source_hash != cj5__hash64(json5, len) ||
+         header->tokens_hash != cj5__hash64(tokens, cj5__cache_tokens_size(num_tokens, compact)))) {
+        return r;
+    }
+
+    r.error = CJ5_ERROR_NONE;
+    r.num_tokens = num_tokens;
+    r.json5 = json5;
+    if (compact) {
+        r.compact = (const cj5_compact_token*)tokens;
+        r.key_hashes = (const uint32_t*)(r.compact + num_tokens);
+    } else {
+        r.tokens = (const cj5_token*)tokens;
+    }
+    return r;
+}
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Helper functions to work with tokens
+#    if CJ5_TOKEN_HELPERS
+#        include <stdlib.h>    // strtod
+
+#        ifndef CJ5_INDEX_MIN_KEYS
+#            define CJ5_INDEX_MIN_KEYS 32
+#        endif
+
+// paths that `cj5_query_batch` resolves together, the rest are done in more groups
+#        define CJ5__QUERY_GROUP 64
+
+typedef struct cj5__index_table {
+    cj5_int object_id;
+    cj5_int mask;       // number of slots - 1
+    cj5_int* slots;     // key token ids, -1 for empty slots
+} cj5__index_table;
+
+typedef struct cj5__index {
+    cj5_int num_tables;
+    cj5__index_table* tables;    // sorted by object_id
+} cj5__index;
+
+static inline cj5_int cj5__index_num_slots(cj5_int num_keys)
+{
+    cj5_int n = 1;
+    while (n < num_keys * 2) {
+        n <<= 1;
+    }
+    return n;
+}
+
+static const cj5__index_table* cj5__index_find(const cj5__index* index, cj5_int object_id)
+{
+    cj5_int lo = 0, hi = index->num_tables - 1;
+    while (lo <= hi) {
+        cj5_int mid = (lo + hi) >> 1;
+        cj5_int id = index->tables[mid].object_id;
+        if (id == object_id) {
+            return &index->tables[mid];
+        } else if (id < object_id) {
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return NULL;
+}
+
+static cj5_int cj5__seek_recursive(cj5_result* r, cj5_int parent_id, uint32_t key_hash)
+{
+    // jump from child to child, skipping the whole subtree of each
+    for (cj5_int i = parent_id + 1, end = cj5__next(r, parent_id); i < end; i = cj5__next(r, i)) {
+        if (!cj5__is_key(r, i)) {
+            continue;
+        }
+
+        CJ5_ASSERT((i + 1) < r->num_tokens);
+        if (key_hash == cj5__key_hash(r, i)) {
+            return i + 1;    // return next "value" token (array/objects and primitive values)
+        } else if (cj5__next(r, i + 1) > i + 2) {
+            cj5_int found_id = cj5__seek_recursive(r, i + 1, key_hash);
+            if (found_id != -1) {
+                return found_id;
+            }
+        }
+    }
+
+    return -1;
+}
+
+// 128-bit approximations of 5^q, q = [CJ5__POW5_MIN, CJ5__POW5_MAX], normalized so the top bit is set
+// negative powers are rounded up. used for decimal to double conversion (Eisel-Lemire algorithm)
+#        define CJ5__POW5_MIN -342
+#        define CJ5__POW5_MAX 308
+static const uint64_t CJ5__POW5_128[][2] = {
+    {0xeef453d6923bd65aULL, 0x113faa2906a13b3fULL}, {0x9558b4661b6565f8ULL, 0x4ac7ca59a424c507ULL},
+    {0xbaaee17fa23ebf76ULL, 0x5d79bcf00d2df649ULL}, {0xe95a99df8ace6f53ULL, 0xf4d82c2c107973dcULL},
+    {0x91d8a02bb6c10594ULL, 0x79071b9b8a4be869ULL}, {0xb64ec836a47146f9ULL, 0x9748e2826cdee284ULL},
+    {0xe3e27a444d8d98b7ULL, 0xfd1b1b2308169b25ULL}, {0x8e6d8c6ab0787f72ULL, 0xfe30f0f5e50e20f7ULL},
+    {0xb208ef855c969f4fULL, 0xbdbd2d335e51a935ULL}, {0xde8b2b66b3bc4723ULL, 0xad2c788035e61382ULL},
+    {0x8b16fb203055ac76ULL, 0x4c3bcb5021afcc31ULL}, {0xaddcb9e83c6b1793ULL, 0xdf4abe242a1bbf3dULL},
+    {0xd953e8624b85dd78ULL, 0xd71d6dad34a2af0dULL}, {0x87d4713d6f33aa6bULL, 0x8672648c40e5ad68ULL},
+    {0xa9c98d8ccb009506ULL, 0x680efdaf511f18c2ULL}, {0xd43bf0effdc0ba48ULL, 0x0212bd1b2566def2ULL},
+    {0x84a57695fe98746dULL, 0x014bb630f7604b57ULL}, {0xa5ced43b7e3e9188ULL, 0x419ea3bd35385e2dULL},
+    {0xcf42894a5dce35eaULL, 0x52064cac828675b9ULL}, {0x818995ce7aa0e1b2ULL, 0x7343efebd1940993ULL},
+    {0xa1ebfb4219491a1fULL, 0x1014ebe6c5f90bf8ULL}, {0xca66fa129f9b60a6ULL, 0xd41a26e077774ef6ULL},
+    {0xfd00b897478238d0ULL, 0x8920b098955522b4ULL}, {0x9e20735e8cb16382ULL, 0x55b46e5f5d5535b0ULL},
+    {0xc5a890362fddbc62ULL, 0xeb2189f734aa831dULL}, {0xf712b443bbd52b7bULL, 0xa5e9ec7501d523e4ULL},
+    {0x9a6bb0aa55653b2dULL, 0x47b233c92125366eULL}, {0xc1069cd4eabe89f8ULL, 0x999ec0bb696e840aULL},
+    {0xf148440a256e2c76ULL, 0xc00670ea43ca250dULL}, {0x96cd2a865764dbcaULL, 0x380406926a5e5728ULL},
+    {0xbc807527ed3e12bcULL, 0xc605083704f5ecf2ULL}, {0xeba09271e88d976bULL, 0xf7864a44c633682eULL},
+    {0x93445b8731587ea3ULL, 0x7ab3ee6afbe0211dULL}, {0xb8157268fdae9e4cULL, 0x5960ea05bad82964ULL},
+    {0xe61acf033d1a45dfULL, 0x6fb92487298e33bdULL}, {0x8fd0c16206306babULL, 0xa5d3b6d479f8e056ULL},
+    {0xb3c4f1ba87bc8696ULL, 0x8f48a4899877186cULL}, {0xe0b62e2929aba83cULL, 0x331acdabfe94de87ULL},
+    {0x8c71dcd9ba0b4925ULL, 0x9ff0c08b7f1d0b14ULL}, {0xaf8e5410288e1b6fULL, 0x07ecf0ae5ee44dd9ULL},
+    {0xdb71e91432b1a24aULL, 0xc9e82cd9f69d6150ULL}, {0x892731ac9faf056eULL, 0xbe311c083a225cd2ULL},
+    {0xab70fe17c79ac6caULL, 0x6dbd630a48aaf406ULL}, {0xd64d3d9db981787dULL, 0x092cbbccdad5b108ULL},
+    {0x85f0468293f0eb4eULL, 0x25bbf56008c58ea5ULL}, {0xa76c582338ed2621ULL, 0xaf2af2b80af6f24eULL},
+    {0xd1476e2c07286faaULL, 0x1af5af660db4aee1ULL}, {0x82cca4db847945caULL, 0x50d98d9fc890ed4dULL},
+    {0xa37fce126597973cULL, 0xe50ff107bab528a0ULL}, {0xcc5fc196fefd7d0cULL, 0x1e53ed49a96272c8ULL},
+    {0xff77b1fcbebcdc4fULL, 0x25e8e89c13bb0f7aULL}, {0x9faacf3df73609b1ULL, 0x77b191618c54e9acULL},
+    {0xc795830d75038c1dULL, 0xd59df5b9ef6a2417ULL}, {0xf97ae3d0d2446f25ULL, 0x4b0573286b44ad1dULL},
+    {0x9becce62836ac577ULL, 0x4ee367f9430aec32ULL}, {0xc2e801fb244576d5ULL, 0x229c41f793cda73fULL},
+    {0xf3a20279ed56d48aULL, 0x6b43527578c1110fULL}, {0x9845418c345644d6ULL, 0x830a13896b78aaa9ULL},
+    {0xbe5691ef416bd60cULL, 0x23cc986bc656d553ULL}, {0xedec366b11c6cb8fULL, 0x2cbfbe86b7ec8aa8ULL},
+    {0x94b3a202eb1c3f39ULL, 0x7bf7d71432f3d6a9ULL}, {0xb9e08a83a5e34f07ULL, 0xdaf5ccd93fb0cc53ULL},
+    {0xe858ad248f5c22c9ULL, 0xd1b3400f8f9cff68ULL}, {0x91376c36d99995beULL, 0x23100809b9c21fa1ULL},
+    {0xb58547448ffffb2dULL, 0xabd40a0c2832a78aULL}, {0xe2e69915b3fff9f9ULL, 0x16c90c8f323f516cULL},
+    {0x8dd01fad907ffc3bULL, 0xae3da7d97f6792e3ULL}, {0xb1442798f49ffb4aULL, 0x99cd11cfdf41779cULL},
+    {0xdd95317f31c7fa1dULL, 0x40405643d711d583ULL}, {0x8a7d3eef7f1cfc52ULL, 0x482835ea666b2572ULL},
+    {0xad1c8eab5ee43b66ULL, 0xda3243650005eecfULL}, {0xd863b256369d4a40ULL, 0x90bed43e40076a82ULL},
+    {0x873e4f75e2224e68ULL, 0x5a7744a6e804a291ULL}, {0xa90de3535aaae202ULL, 0x711515d0a205cb36ULL},
+    {0xd3515c2831559a83ULL, 0x0d5a5b44ca873e03ULL}, {0x8412d9991ed58091ULL, 0xe858790afe9486c2ULL},
+    {0xa5178fff668ae0b6ULL, 0x626e974dbe39a872ULL}, {0xce5d73ff402d98e3ULL, 0xfb0a3d212dc8128fULL},
+    {0x80fa687f881c7f8eULL, 0x7ce66634bc9d0b99ULL}, {0xa139029f6a239f72ULL, 0x1c1fffc1ebc44e80ULL},
+    {0xc987434744ac874eULL, 0xa327ffb266b56220ULL}, {0xfbe9141915d7a922ULL, 0x4bf1ff9f0062baa8ULL},
+    {0x9d71ac8fada6c9b5ULL, 0x6f773fc3603db4a9ULL}, {0xc4ce17b399107c22ULL, 0xcb550fb4384d21d3ULL},
+    {0xf6019da07f549b2bULL, 0x7e2a53a146606a48ULL}, {0x99c102844f94e0fbULL, 0x2eda7444cbfc426dULL},
+    {0xc0314325637a1939ULL, 0xfa911155fefb5308ULL}, {0xf03d93eebc589f88ULL, 0x793555ab7eba27caULL},
+    {0x96267c7535b763b5ULL, 0x4bc1558b2f3458deULL}, {0xbbb01b9283253ca2ULL, 0x9eb1aaedfb016f16ULL},
+    {0xea9c227723ee8bcbULL, 0x465e15a979c1cadcULL}, {0x92a1958a7675175fULL, 0x0bfacd89ec191ec9ULL},
+    {0xb749faed14125d36ULL, 0xcef980ec671f667bULL}, {0xe51c79a85916f484ULL, 0x82b7e12780e7401aULL},
+    {0x8f31cc0937ae58d2ULL, 0xd1b2ecb8b0908810ULL}, {0xb2fe3f0b8599ef07ULL, 0x861fa7e6dcb4aa15ULL},
+    {0xdfbdcece67006ac9ULL, 0x67a791e093e1d49aULL}, {0x8bd6a141006042bdULL, 0xe0c8bb2c5c6d24e0ULL},
+    {0xaecc49914078536dULL, 0x58fae9f773886e18ULL}, {0xda7f5bf590966848ULL, 0xaf39a475506a899eULL},
+    {0x888f99797a5e012dULL, 0x6d8406c952429603ULL}, {0xaab37fd7d8f58178ULL, 0xc8e5087ba6d33b83ULL},
+    {0xd5605fcdcf32e1d6ULL, 0xfb1e4a9a90880a64ULL}, {0x855c3be0a17fcd26ULL, 0x5cf2eea09a55067fULL},
+    {0xa6b34ad8c9dfc06fULL, 0xf42faa48c0ea481eULL}, {0xd0601d8efc57b08bULL, 0xf13b94daf124da26ULL},
+    {0x823c12795db6ce57ULL, 0x76c53d08d6b70858ULL}, {0xa2cb1717b52481edULL, 0x54768c4b0c64ca6eULL},
+    {0xcb7ddcdda26da268ULL, 0xa9942f5dcf7dfd09ULL}, {0xfe5d54150b090b02ULL, 0xd3f93b35435d7c4cULL},
+    {0x9efa548d26e5a6e1ULL, 0xc47bc5014a1a6dafULL}, {0xc6b8e9b0709f109aULL, 0x359ab6419ca1091bULL},
+    {0xf867241c8cc6d4c0ULL, 0xc30163d203c94b62ULL}, {0x9b407691d7fc44f8ULL, 0x79e0de63425dcf1dULL},
+    {0xc21094364dfb5636ULL, 0x985915fc12f542e4ULL}, {0xf294b943e17a2bc4ULL, 0x3e6f5b7b17b2939dULL},
+    {0x979cf3ca6cec5b5aULL, 0xa705992ceecf9c42ULL}, {0xbd8430bd08277231ULL, 0x50c6ff782a838353ULL},
+    {0xece53cec4a314ebdULL, 0xa4f8bf5635246428ULL}, {0x940f4613ae5ed136ULL, 0x871b7795e136be99ULL},
+    {0xb913179899f68584ULL, 0x28e2557b59846e3fULL}, {0xe757dd7ec07426e5ULL, 0x331aeada2fe589cfULL},
+    {0x9096ea6f3848984fULL, 0x3ff0d2c85def7621ULL}, {0xb4bca50b065abe63ULL, 0x0fed077a756b53a9ULL},
+    {0xe1ebce4dc7f16dfbULL, 0xd3e8495912c62894ULL}, {0x8d3360f09cf6e4bdULL, 0x64712dd7abbbd95cULL},
+    {0xb080392cc4349decULL, 0xbd8d794d96aacfb3ULL}, {0xdca04777f541c567ULL, 0xecf0d7a0fc5583a0ULL},
+    {0x89e42caaf9491b60ULL, 0xf41686c49db57244ULL}, {0xac5d37d5b79b6239ULL, 0x311c2875c522ced5ULL},
+    {0xd77485cb25823ac7ULL, 0x7d633293366b828bULL}, {0x86a8d39ef77164bcULL, 0xae5dff9c02033197ULL},
+    {0xa8530886b54dbdebULL, 0xd9f57f830283fdfcULL}, {0xd267caa862a12d66ULL, 0xd072df63c324fd7bULL},
+    {0x8380dea93da4bc60ULL, 0x4247cb9e59f71e6dULL}, {0xa46116538d0deb78ULL, 0x52d9be85f074e608ULL},
+    {0xcd795be870516656ULL, 0x67902e276c921f8bULL}, {0x806bd9714632dff6ULL, 0x00ba1cd8a3db53b6ULL},
+    {0xa086cfcd97bf97f3ULL, 0x80e8a40eccd228a4ULL}, {0xc8a883c0fdaf7df0ULL, 0x6122cd128006b2cdULL},
+    {0xfad2a4b13d1b5d6cULL, 0x796b805720085f81ULL}, {0x9cc3a6eec6311a63ULL, 0xcbe3303674053bb0ULL},
+    {0xc3f490aa77bd60fcULL, 0xbedbfc4411068a9cULL}, {0xf4f1b4d515acb93bULL, 0xee92fb5515482d44ULL},
+    {0x991711052d8bf3c5ULL, 0x751bdd152d4d1c4aULL}, {0xbf5cd54678eef0b6ULL, 0xd262d45a78a0635dULL},
+    {0xef340a98172aace4ULL, 0x86fb897116c87c34ULL}, {0x9580869f0e7aac0eULL, 0xd45d35e6ae3d4da0ULL},
+    {0xbae0a846d2195712ULL, 0x8974836059cca109ULL}, {0xe998d258869facd7ULL, 0x2bd1a438703fc94bULL},
+    {0x91ff83775423cc06ULL, 0x7b6306a34627ddcfULL}, {0xb67f6455292cbf08ULL, 0x1a3bc84c17b1d542ULL},
+    {0xe41f3d6a7377eecaULL, 0x20caba5f1d9e4a93ULL}, {0x8e938662882af53eULL, 0x547eb47b7282ee9cULL},
+    {0xb23867fb2a35b28dULL, 0xe99e619a4f23aa43ULL}, {0xdec681f9f4c31f31ULL, 0x6405fa00e2ec94d4ULL},
+    {0x8b3c113c38f9f37eULL, 0xde83bc408dd3dd04ULL}, {0xae0b158b4738705eULL, 0x9624ab50b148d445ULL},
+    {0xd98ddaee19068c76ULL, 0x3badd624dd9b0957ULL}, {0x87f8a8d4cfa417c9ULL, 0xe54ca5d70a80e5d6ULL},
+    {0xa9f6d30a038d1dbcULL, 0x5e9fcf4ccd211f4cULL}, {0xd47487cc8470652bULL, 0x7647c3200069671fULL},
+    {0x84c8d4dfd2c63f3bULL, 0x29ecd9f40041e073ULL}, {0xa5fb0a17c777cf09ULL, 0xf468107100525890ULL},
+    {0xcf79cc9db955c2ccULL, 0x7182148d4066eeb4ULL}, {0x81ac1fe293d599bfULL, 0xc6f14cd848405530ULL},
+    {0xa21727db38cb002fULL, 0xb8ada00e5a506a7cULL}, {0xca9cf1d206fdc03bULL, 0xa6d90811f0e4851cULL},
+    {0xfd442e4688bd304aULL, 0x908f4a166d1da663ULL}, {0x9e4a9cec15763e2eULL, 0x9a598e4e043287feULL},
+    {0xc5dd44271ad3cdbaULL, 0x40eff1e1853f29fdULL}, {0xf7549530e188c128ULL, 0xd12bee59e68ef47cULL},
+    {0x9a94dd3e8cf578b9ULL, 0x82bb74f8301958ceULL}, {0xc13a148e3032d6e7ULL, 0xe36a52363c1faf01ULL},
+    {0xf18899b1bc3f8ca1ULL, 0xdc44e6c3cb279ac1ULL}, {0x96f5600f15a7b7e5ULL, 0x29ab103a5ef8c0b9ULL},
+    {0xbcb2b812db11a5deULL, 0x7415d448f6b6f0e7ULL}, {0xebdf661791d60f56ULL, 0x111b495b3464ad21ULL},
+    {0x936b9fcebb25c995ULL, 0xcab10dd900beec34ULL}, {0xb84687c269ef3bfbULL, 0x3d5d514f40eea742ULL},
+    {0xe65829b3046b0afaULL, 0x0cb4a5a3112a5112ULL}, {0x8ff71a0fe2c2e6dcULL, 0x47f0e785eaba72abULL},
+    {0xb3f4e093db73a093ULL, 0x59ed216765690f56ULL}, {0xe0f218b8d25088b8ULL, 0x306869c13ec3532cULL},
+    {0x8c974f7383725573ULL, 0x1e414218c73a13fbULL}, {0xafbd2350644eeacfULL, 0xe5d1929ef90898faULL},
+    {0xdbac6c247d62a583ULL, 0xdf45f746b74abf39ULL}, {0x894bc396ce5da772ULL, 0x6b8bba8c328eb783ULL},
+    {0xab9eb47c81f5114fULL, 0x066ea92f3f326564ULL}, {0xd686619ba27255a2ULL, 0xc80a537b0efefebdULL},
+    {0x8613fd0145877585ULL, 0xbd06742ce95f5f36ULL}, {0xa798fc4196e952e7ULL, 0x2c48113823b73704ULL},
+    {0xd17f3b51fca3a7a0ULL, 0xf75a15862ca504c5ULL}, {0x82ef85133de648c4ULL, 0x9a984d73dbe722fbULL},
+    {0xa3ab66580d5fdaf5ULL, 0xc13e60d0d2e0ebbaULL}, {0xcc963fee10b7d1b3ULL, 0x318df905079926a8ULL},
+    {0xffbbcfe994e5c61fULL, 0xfdf17746497f7052ULL}, {0x9fd561f1fd0f9bd3ULL, 0xfeb6ea8bedefa633ULL},
+    {0xc7caba6e7c5382c8ULL, 0xfe64a52ee96b8fc0ULL}, {0xf9bd690a1b68637bULL, 0x3dfdce7aa3c673b0ULL},
+    {0x9c1661a651213e2dULL, 0x06bea10ca65c084eULL}, {0xc31bfa0fe5698db8ULL, 0x486e494fcff30a62ULL},
+    {0xf3e2f893dec3f126ULL, 0x5a89dba3c3efccfaULL}, {0x986ddb5c6b3a76b7ULL, 0xf89629465a75e01cULL},
+    {0xbe89523386091465ULL, 0xf6bbb397f1135823ULL}, {0xee2ba6c0678b597fULL, 0x746aa07ded582e2cULL},
+    {0x94db483840b717efULL, 0xa8c2a44eb4571cdcULL}, {0xba121a4650e4ddebULL, 0x92f34d62616ce413ULL},
+    {0xe896a0d7e51e1566ULL, 0x77b020baf9c81d17ULL}, {0x915e2486ef32cd60ULL, 0x0ace1474dc1d122eULL},
+    {0xb5b5ada8aaff80b8ULL, 0x0d819992132456baULL}, {0xe3231912d5bf60e6ULL, 0x10e1fff697ed6c69ULL},
+    {0x8df5efabc5979c8fULL, 0xca8d3ffa1ef463c1ULL}, {0xb1736b96b6fd83b3ULL, 0xbd308ff8a6b17cb2ULL},
+    {0xddd0467c64bce4a0ULL, 0xac7cb3f6d05ddbdeULL}, {0x8aa22c0dbef60ee4ULL, 0x6bcdf07a423aa96bULL},
+    {0xad4ab7112eb3929dULL, 0x86c16c98d2c953c6ULL}, {0xd89d64d57a607744ULL, 0xe871c7bf077ba8b7ULL},
+    {0x87625f056c7c4a8bULL, 0x11471cd764ad4972ULL}, {0xa93af6c6c79b5d2dULL, 0xd598e40d3dd89bcfULL},
+    {0xd389b47879823479ULL, 0x4aff1d108d4ec2c3ULL}, {0x843610cb4bf160cbULL, 0xcedf722a585139baULL},
+    {0xa54394fe1eedb8feULL, 0xc2974eb4ee658828ULL}, {0xce947a3da6a9273eULL, 0x733d226229feea32ULL},
+    {0x811ccc668829b887ULL, 0x0806357d5a3f525fULL}, {0xa163ff802a3426a8ULL, 0xca07c2dcb0cf26f7ULL},
+    {0xc9bcff6034c13052ULL, 0xfc89b393dd02f0b5ULL}, {0xfc2c3f3841f17c67ULL, 0xbbac2078d443ace2ULL},
+    {0x9d9ba7832936edc0ULL, 0xd54b944b84aa4c0dULL}, {0xc5029163f384a931ULL, 0x0a9e795e65d4df11ULL},
+    {0xf64335bcf065d37dULL, 0x4d4617b5ff4a16d5ULL}, {0x99ea0196163fa42eULL, 0x504bced1bf8e4e45ULL},
+    {0xc06481fb9bcf8d39ULL, 0xe45ec2862f71e1d6ULL}, {0xf07da27a82c37088ULL, 0x5d767327bb4e5a4cULL},
+    {0x964e858c91ba2655ULL, 0x3a6a07f8d510f86fULL}, {0xbbe226efb628afeaULL, 0x890489f70a55368bULL},
+    {0xeadab0aba3b2dbe5ULL, 0x2b45ac74ccea842eULL}, {0x92c8ae6b464fc96fULL, 0x3b0b8bc90012929dULL},
+    {0xb77ada0617e3bbcbULL, 0x09ce6ebb40173744ULL}, {0xe55990879ddcaabdULL, 0xcc420a6a101d0515ULL},
+    {0x8f57fa54c2a9eab6ULL, 0x9fa946824a12232dULL}, {0xb32df8e9f3546564ULL, 0x47939822dc96abf9ULL},
+    {0xdff9772470297ebdULL, 0x59787e2b93bc56f7ULL}, {0x8bfbea76c619ef36ULL, 0x57eb4edb3c55b65aULL},
+    {0xaefae51477a06b03ULL, 0xede622920b6b23f1ULL}, {0xdab99e59958885c4ULL, 0xe95fab368e45ecedULL},
+    {0x88b402f7fd75539bULL, 0x11dbcb0218ebb414ULL}, {0xaae103b5fcd2a881ULL, 0xd652bdc29f26a119ULL},
+    {0xd59944a37c0752a2ULL, 0x4be76d3346f0495fULL}, {0x857fcae62d8493a5ULL, 0x6f70a4400c562ddbULL},
+    {0xa6dfbd9fb8e5b88eULL, 0xcb4ccd500f6bb952ULL}, {0xd097ad07a71f26b2ULL, 0x7e2000a41346a7a7ULL},
+    {0x825ecc24c873782fULL, 0x8ed400668c0c28c8ULL}, {0xa2f67f2dfa90563bULL, 0x728900802f0f32faULL},
+    {0xcbb41ef979346bcaULL, 0x4f2b40a03ad2ffb9ULL}, {0xfea126b7d78186bcULL, 0xe2f610c84987bfa8ULL},
+    {0x9f24b832e6b0f436ULL, 0x0dd9ca7d2df4d7c9ULL}, {0xc6ede63fa05d3143ULL, 0x91503d1c79720dbbULL},
+    {0xf8a95fcf88747d94ULL, 0x75a44c6397ce912aULL}, {0x9b69dbe1b548ce7cULL, 0xc986afbe3ee11abaULL},
+    {0xc24452da229b021bULL, 0xfbe85badce996168ULL}, {0xf2d56790ab41c2a2ULL, 0xfae27299423fb9c3ULL},
+    {0x97c560ba6b0919a5ULL, 0xdccd879fc967d41aULL}, {0xbdb6b8e905cb600fULL, 0x5400e987bbc1c920ULL},
+    {0xed246723473e3813ULL, 0x290123e9aab23b68ULL}, {0x9436c0760c86e30bULL, 0xf9a0b6720aaf6521ULL},
+    {0xb94470938fa89bceULL, 0xf808e40e8d5b3e69ULL}, {0xe7958cb87392c2c2ULL, 0xb60b1d1230b20e04ULL},
+    {0x90bd77f3483bb9b9ULL, 0xb1c6f22b5e6f48c2ULL}, {0xb4ecd5f01a4aa828ULL, 0x1e38aeb6360b1af3ULL},
+    {0xe2280b6c20dd5232ULL, 0x25c6da63c38de1b0ULL}, {0x8d590723948a535fULL, 0x579c487e5a38ad0eULL},
+    {0xb0af48ec79ace837ULL, 0x2d835a9df0c6d851ULL}, {0xdcdb1b2798182244ULL, 0xf8e431456cf88e65ULL},
+    {0x8a08f0f8bf0f156bULL, 0x1b8e9ecb641b58ffULL}, {0xac8b2d36eed2dac5ULL, 0xe272467e3d222f3fULL},
+    {0xd7adf884aa879177ULL, 0x5b0ed81dcc6abb0fULL}, {0x86ccbb52ea94baeaULL, 0x98e947129fc2b4e9ULL},
+    {0xa87fea27a539e9a5ULL, 0x3f2398d747b36224ULL}, {0xd29fe4b18e88640eULL, 0x8eec7f0d19a03aadULL},
+    {0x83a3eeeef9153e89ULL, 0x1953cf68300424acULL}, {0xa48ceaaab75a8e2bULL, 0x5fa8c3423c052dd7ULL},
+    {0xcdb02555653131b6ULL, 0x3792f412cb06794dULL}, {0x808e17555f3ebf11ULL, 0xe2bbd88bbee40bd0ULL},
+    {0xa0b19d2ab70e6ed6ULL, 0x5b6aceaeae9d0ec4ULL}, {0xc8de047564d20a8bULL, 0xf245825a5a445275ULL},
+    {0xfb158592be068d2eULL, 0xeed6e2f0f0d56712ULL}, {0x9ced737bb6c4183dULL, 0x55464dd69685606bULL},
+    {0xc428d05aa4751e4cULL, 0xaa97e14c3c26b886ULL}, {0xf53304714d9265dfULL, 0xd53dd99f4b3066a8ULL},
+    {0x993fe2c6d07b7fabULL, 0xe546a8038efe4029ULL}, {0xbf8fdb78849a5f96ULL, 0xde98520472bdd033ULL},
+    {0xef73d256a5c0f77cULL, 0x963e66858f6d4440ULL}, {0x95a8637627989aadULL, 0xdde7001379a44aa8ULL},
+    {0xbb127c53b17ec159ULL, 0x5560c018580d5d52ULL}, {0xe9d71b689dde71afULL, 0xaab8f01e6e10b4a6ULL},
+    {0x9226712162ab070dULL, 0xcab3961304ca70e8ULL}, {0xb6b00d69bb55c8d1ULL, 0x3d607b97c5fd0d22ULL},
+    {0xe45c10c42a2b3b05ULL, 0x8cb89a7db77c506aULL}, {0x8eb98a7a9a5b04e3ULL, 0x77f3608e92adb242ULL},
+    {0xb267ed1940f1c61cULL, 0x55f038b237591ed3ULL}, {0xdf01e85f912e37a3ULL, 0x6b6c46dec52f6688ULL},
+    {0x8b61313bbabce2c6ULL, 0x2323ac4b3b3da015ULL}, {0xae397d8aa96c1b77ULL, 0xabec975e0a0d081aULL},
+    {0xd9c7dced53c72255ULL, 0x96e7bd358c904a21ULL}, {0x881cea14545c7575ULL, 0x7e50d64177da2e54ULL},
+    {0xaa242499697392d2ULL, 0xdde50bd1d5d0b9e9ULL}, {0xd4ad2dbfc3d07787ULL, 0x955e4ec64b44e864ULL},
+    {0x84ec3c97da624ab4ULL, 0xbd5af13bef0b113eULL}, {0xa6274bbdd0fadd61ULL, 0xecb1ad8aeacdd58eULL},
+    {0xcfb11ead453994baULL, 0x67de18eda5814af2ULL}, {0x81ceb32c4b43fcf4ULL, 0x80eacf948770ced7ULL},
+    {0xa2425ff75e14fc31ULL, 0xa1258379a94d028dULL}, {0xcad2f7f5359a3b3eULL, 0x096ee45813a04330ULL},
+    {0xfd87b5f28300ca0dULL, 0x8bca9d6e188853fcULL}, {0x9e74d1b791e07e48ULL, 0x775ea264cf55347eULL},
+    {0xc612062576589ddaULL, 0x95364afe032a819eULL}, {0xf79687aed3eec551ULL, 0x3a83ddbd83f52205ULL},
+    {0x9abe14cd44753b52ULL, 0xc4926a9672793543ULL}, {0xc16d9a0095928a27ULL, 0x75b7053c0f178294ULL},
+    {0xf1c90080baf72cb1ULL, 0x5324c68b12dd6339ULL}, {0x971da05074da7beeULL, 0xd3f6fc16ebca5e04ULL},
+    {0xbce5086492111aeaULL, 0x88f4bb1ca6bcf585ULL}, {0xec1e4a7db69561a5ULL, 0x2b31e9e3d06c32e6ULL},
+    {0x9392ee8e921d5d07ULL, 0x3aff322e62439fd0ULL}, {0xb877aa3236a4b449ULL, 0x09befeb9fad487c3ULL},
+    {0xe69594bec44de15bULL, 0x4c2ebe687989a9b4ULL}, {0x901d7cf73ab0acd9ULL, 0x0f9d37014bf60a11ULL},
+    {0xb424dc35095cd80fULL, 0x538484c19ef38c95ULL}, {0xe12e13424bb40e13ULL, 0x2865a5f206b06fbaULL},
+    {0x8cbccc096f5088cbULL, 0xf93f87b7442e45d4ULL}, {0xafebff0bcb24aafeULL, 0xf78f69a51539d749ULL},
+    {0xdbe6fecebdedd5beULL, 0xb573440e5a884d1cULL}, {0x89705f4136b4a597ULL, 0x31680a88f8953031ULL},
+    {0xabcc77118461cefcULL, 0xfdc20d2b36ba7c3eULL}, {0xd6bf94d5e57a42bcULL, 0x3d32907604691b4dULL},
+    {0x8637bd05af6c69b5ULL, 0xa63f9a49c2c1b110ULL}, {0xa7c5ac471b478423ULL, 0x0fcf80dc33721d54ULL},
+    {0xd1b71758e219652bULL, 0xd3c36113404ea4a9ULL}, {0x83126e978d4fdf3bULL, 0x645a1cac083126eaULL},
+    {0xa3d70a3d70a3d70aULL, 0x3d70a3d70a3d70a4ULL}, {0xccccccccccccccccULL, 0xcccccccccccccccdULL},
+    {0x8000000000000000ULL, 0x0000000000000000ULL}, {0xa000000000000000ULL, 0x0000000000000000ULL},
+    {0xc800000000000000ULL, 0x0000000000000000ULL}, {0xfa00000000000000ULL, 0x0000000000000000ULL},
+    {0x9c40000000000000ULL, 0x0000000000000000ULL}, {0xc350000000000000ULL, 0x0000000000000000ULL},
+    {0xf424000000000000ULL, 0x0000000000000000ULL}, {0x9896800000000000ULL, 0x0000000000000000ULL},
+    {0xbebc200000000000ULL, 0x0000000000000000ULL}, {0xee6b280000000000ULL, 0x0000000000000000ULL},
+    {0x9502f90000000000ULL, 0x0000000000000000ULL}, {0xba43b74000000000ULL, 0x0000000000000000ULL},
+    {0xe8d4a51000000000ULL, 0x0000000000000000ULL}, {0x9184e72a00000000ULL, 0x0000000000000000ULL},
+    {0xb5e620f480000000ULL, 0x0000000000000000ULL}, {0xe35fa931a0000000ULL, 0x0000000000000000ULL},
+    {0x8e1bc9bf04000000ULL, 0x0000000000000000ULL}, {0xb1a2bc2ec5000000ULL, 0x0000000000000000ULL},
+    {0xde0b6b3a76400000ULL, 0x0000000000000000ULL}, {0x8ac7230489e80000ULL, 0x0000000000000000ULL},
+    {0xad78ebc5ac620000ULL, 0x0000000000000000ULL}, {0xd8d726b7177a8000ULL, 0x0000000000000000ULL},
+    {0x878678326eac9000ULL, 0x0000000000000000ULL}, {0xa968163f0a57b400ULL, 0x0000000000000000ULL},
+    {0xd3c21bcecceda100ULL, 0x0000000000000000ULL}, {0x84595161401484a0ULL, 0x0000000000000000ULL},
+    {0xa56fa5b99019a5c8ULL, 0x0000000000000000ULL}, {0xcecb8f27f4200f3aULL, 0x0000000000000000ULL},
+    {0x813f3978f8940984ULL, 0x4000000000000000ULL}, {0xa18f07d736b90be5ULL, 0x5000000000000000ULL},
+    {0xc9f2c9cd04674edeULL, 0xa400000000000000ULL}, {0xfc6f7c4045812296ULL, 0x4d00000000000000ULL},
+    {0x9dc5ada82b70b59dULL, 0xf020000000000000ULL}, {0xc5371912364ce305ULL, 0x6c28000000000000ULL},
+    {0xf684df56c3e01bc6ULL, 0xc732000000000000ULL}, {0x9a130b963a6c115cULL, 0x3c7f400000000000ULL},
+    {0xc097ce7bc90715b3ULL, 0x4b9f100000000000ULL}, {0xf0bdc21abb48db20ULL, 0x1e86d40000000000ULL},
+    {0x96769950b50d88f4ULL, 0x1314448000000000ULL}, {0xbc143fa4e250eb31ULL, 0x17d955a000000000ULL},
+    {0xeb194f8e1ae525fdULL, 0x5dcfab0800000000ULL}, {0x92efd1b8d0cf37beULL, 0x5aa1cae500000000ULL},
+    {0xb7abc627050305adULL, 0xf14a3d9e40000000ULL}, {0xe596b7b0c643c719ULL, 0x6d9ccd05d0000000ULL},
+    {0x8f7e32ce7bea5c6fULL, 0xe4820023a2000000ULL}, {0xb35dbf821ae4f38bULL, 0xdda2802c8a800000ULL},
+    {0xe0352f62a19e306eULL, 0xd50b2037ad200000ULL}, {0x8c213d9da502de45ULL, 0x4526f422cc340000ULL},
+    {0xaf298d050e4395d6ULL, 0x9670b12b7f410000ULL}, {0xdaf3f04651d47b4cULL, 0x3c0cdd765f114000ULL},
+    {0x88d8762bf324cd0fULL, 0xa5880a69fb6ac800ULL}, {0xab0e93b6efee0053ULL, 0x8eea0d047a457a00ULL},
+    {0xd5d238a4abe98068ULL, 0x72a4904598d6d880ULL}, {0x85a36366eb71f041ULL, 0x47a6da2b7f864750ULL},
+    {0xa70c3c40a64e6c51ULL, 0x999090b65f67d924ULL}, {0xd0cf4b50cfe20765ULL, 0xfff4b4e3f741cf6dULL},
+    {0x82818f1281ed449fULL, 0xbff8f10e7a8921a4ULL}, {0xa321f2d7226895c7ULL, 0xaff72d52192b6a0dULL},
+    {0xcbea6f8ceb02bb39ULL, 0x9bf4f8a69f764490ULL}, {0xfee50b7025c36a08ULL, 0x02f236d04753d5b4ULL},
+    {0x9f4f2726179a2245ULL, 0x01d762422c946590ULL}, {0xc722f0ef9d80aad6ULL, 0x424d3ad2b7b97ef5ULL},
+    {0xf8ebad2b84e0d58bULL, 0xd2e0898765a7deb2ULL}, {0x9b934c3b330c8577ULL, 0x63cc55f49f88eb2fULL},
+    {0xc2781f49ffcfa6d5ULL, 0x3cbf6b71c76b25fbULL}, {0xf316271c7fc3908aULL, 0x8bef464e3945ef7aULL},
+    {0x97edd871cfda3a56ULL, 0x97758bf0e3cbb5acULL}, {0xbde94e8e43d0c8ecULL, 0x3d52eeed1cbea317ULL},
+    {0xed63a231d4c4fb27ULL, 0x4ca7aaa863ee4bddULL}, {0x945e455f24fb1cf8ULL, 0x8fe8caa93e74ef6aULL},
+    {0xb975d6b6ee39e436ULL, 0xb3e2fd538e122b44ULL}, {0xe7d34c64a9c85d44ULL, 0x60dbbca87196b616ULL},
+    {0x90e40fbeea1d3a4aULL, 0xbc8955e946fe31cdULL}, {0xb51d13aea4a488ddULL, 0x6babab6398bdbe41ULL},
+    {0xe264589a4dcdab14ULL, 0xc696963c7eed2dd1ULL}, {0x8d7eb76070a08aecULL, 0xfc1e1de5cf543ca2ULL},
+    {0xb0de65388cc8ada8ULL, 0x3b25a55f43294bcbULL}, {0xdd15fe86affad912ULL, 0x49ef0eb713f39ebeULL},
+    {0x8a2dbf142dfcc7abULL, 0x6e3569326c784337ULL}, {0xacb92ed9397bf996ULL, 0x49c2c37f07965404ULL},
+    {0xd7e77a8f87daf7fbULL, 0xdc33745ec97be906ULL}, {0x86f0ac99b4e8dafdULL, 0x69a028bb3ded71a3ULL},
+    {0xa8acd7c0222311bcULL, 0xc40832ea0d68ce0cULL}, {0xd2d80db02aabd62bULL, 0xf50a3fa490c30190ULL},
+    {0x83c7088e1aab65dbULL, 0x792667c6da79e0faULL}, {0xa4b8cab1a1563f52ULL, 0x577001b891185938ULL},
+    {0xcde6fd5e09abcf26ULL, 0xed4c0226b55e6f86ULL}, {0x80b05e5ac60b6178ULL, 0x544f8158315b05b4ULL},
+    {0xa0dc75f1778e39d6ULL, 0x696361ae3db1c721ULL}, {0xc913936dd571c84cULL, 0x03bc3a19cd1e38e9ULL},
+    {0xfb5878494ace3a5fULL, 0x04ab48a04065c723ULL}, {0x9d174b2dcec0e47bULL, 0x62eb0d64283f9c76ULL},
+    {0xc45d1df942711d9aULL, 0x3ba5d0bd324f8394ULL}, {0xf5746577930d6500ULL, 0xca8f44ec7ee36479ULL},
+    {0x9968bf6abbe85f20ULL, 0x7e998b13cf4e1ecbULL}, {0xbfc2ef456ae276e8ULL, 0x9e3fedd8c321a67eULL},
+    {0xefb3ab16c59b14a2ULL, 0xc5cfe94ef3ea101eULL}, {0x95d04aee3b80ece5ULL, 0xbba1f1d158724a12ULL},
+    {0xbb445da9ca61281fULL, 0x2a8a6e45ae8edc97ULL}, {0xea1575143cf97226ULL, 0xf52d09d71a3293bdULL},
+    {0x924d692ca61be758ULL, 0x593c2626705f9c56ULL}, {0xb6e0c377cfa2e12eULL, 0x6f8b2fb00c77836cULL},
+    {0xe498f455c38b997aULL, 0x0b6dfb9c0f956447ULL}, {0x8edf98b59a373fecULL, 0x4724bd4189bd5eacULL},
+    {0xb2977ee300c50fe7ULL, 0x58edec91ec2cb657ULL}, {0xdf3d5e9bc0f653e1ULL, 0x2f2967b66737e3edULL},
+    {0x8b865b215899f46cULL, 0xbd79e0d20082ee74ULL}, {0xae67f1e9aec07187ULL, 0xecd8590680a3aa11ULL},
+    {0xda01ee641a708de9ULL, 0xe80e6f4820cc9495ULL}, {0x884134fe908658b2ULL, 0x3109058d147fdcddULL},
+    {0xaa51823e34a7eedeULL, 0xbd4b46f0599fd415ULL}, {0xd4e5e2cdc1d1ea96ULL, 0x6c9e18ac7007c91aULL},
+    {0x850fadc09923329eULL, 0x03e2cf6bc604ddb0ULL}, {0xa6539930bf6bff45ULL, 0x84db8346b786151cULL},
+    {0xcfe87f7cef46ff16ULL, 0xe612641865679a63ULL}, {0x81f14fae158c5f6eULL, 0x4fcb7e8f3f60c07eULL},
+    {0xa26da3999aef7749ULL, 0xe3be5e330f38f09dULL}, {0xcb090c8001ab551cULL, 0x5cadf5bfd3072cc5ULL},
+    {0xfdcb4fa002162a63ULL, 0x73d9732fc7c8f7f6ULL}, {0x9e9f11c4014dda7eULL, 0x2867e7fddcdd9afaULL},
+    {0xc646d63501a1511dULL, 0xb281e1fd541501b8ULL}, {0xf7d88bc24209a565ULL, 0x1f225a7ca91a4226ULL},
+    {0x9ae757596946075fULL, 0x3375788de9b06958ULL}, {0xc1a12d2fc3978937ULL, 0x0052d6b1641c83aeULL},
+    {0xf209787bb47d6b84ULL, 0xc0678c5dbd23a49aULL}, {0x9745eb4d50ce6332ULL, 0xf840b7ba963646e0ULL},
+    {0xbd176620a501fbffULL, 0xb650e5a93bc3d898ULL}, {0xec5d3fa8ce427affULL, 0xa3e51f138ab4cebeULL},
+    {0x93ba47c980e98cdfULL, 0xc66f336c36b10137ULL}, {0xb8a8d9bbe123f017ULL, 0xb80b0047445d4184ULL},
+    {0xe6d3102ad96cec1dULL, 0xa60dc059157491e5ULL}, {0x9043ea1ac7e41392ULL, 0x87c89837ad68db2fULL},
+    {0xb454e4a179dd1877ULL, 0x29babe4598c311fbULL}, {0xe16a1dc9d8545e94ULL, 0xf4296dd6fef3d67aULL},
+    {0x8ce2529e2734bb1dULL, 0x1899e4a65f58660cULL}, {0xb01ae745b101e9e4ULL, 0x5ec05dcff72e7f8fULL},
+    {0xdc21a1171d42645dULL, 0x76707543f4fa1f73ULL}, {0x899504ae72497ebaULL, 0x6a06494a791c53a8ULL},
+    {0xabfa45da0edbde69ULL, 0x0487db9d17636892ULL}, {0xd6f8d7509292d603ULL, 0x45a9d2845d3c42b6ULL},
+    {0x865b86925b9bc5c2ULL, 0x0b8a2392ba45a9b2ULL}, {0xa7f26836f282b732ULL, 0x8e6cac7768d7141eULL},
+    {0xd1ef0244af2364ffULL, 0x3207d795430cd926ULL}, {0x8335616aed761f1fULL, 0x7f44e6bd49e807b8ULL},
+    {0xa402b9c5a8d3a6e7ULL, 0x5f16206c9c6209a6ULL}, {0xcd036837130890a1ULL, 0x36dba887c37a8c0fULL},
+    {0x802221226be55a64ULL, 0xc2494954da2c9789ULL}, {0xa02aa96b06deb0fdULL, 0xf2db9baa10b7bd6cULL},
+    {0xc83553c5c8965d3dULL, 0x6f92829494e5acc7ULL}, {0xfa42a8b73abbf48cULL, 0xcb772339ba1f17f9ULL},
+    {0x9c69a97284b578d7ULL, 0xff2a760414536efbULL}, {0xc38413cf25e2d70dULL, 0xfef5138519684abaULL},
+    {0xf46518c2ef5b8cd1ULL, 0x7eb258665fc25d69ULL}, {0x98bf2f79d5993802ULL, 0xef2f773ffbd97a61ULL},
+    {0xbeeefb584aff8603ULL, 0xaafb550ffacfd8faULL}, {0xeeaaba2e5dbf6784ULL, 0x95ba2a53f983cf38ULL},
+    {0x952ab45cfa97a0b2ULL, 0xdd945a747bf26183ULL}, {0xba756174393d88dfULL, 0x94f971119aeef9e4ULL},
+    {0xe912b9d1478ceb17ULL, 0x7a37cd5601aab85dULL}, {0x91abb422ccb812eeULL, 0xac62e055c10ab33aULL},
+    {0xb616a12b7fe617aaULL, 0x577b986b314d6009ULL}, {0xe39c49765fdf9d94ULL, 0xed5a7e85fda0b80bULL},
+    {0x8e41ade9fbebc27dULL, 0x14588f13be847307ULL}, {0xb1d219647ae6b31cULL, 0x596eb2d8ae258fc8ULL},
+    {0xde469fbd99a05fe3ULL, 0x6fca5f8ed9aef3bbULL}, {0x8aec23d680043beeULL, 0x25de7bb9480d5854ULL},
+    {0xada72ccc20054ae9ULL, 0xaf561aa79a10ae6aULL}, {0xd910f7ff28069da4ULL, 0x1b2ba1518094da04ULL},
+    {0x87aa9aff79042286ULL, 0x90fb44d2f05d0842ULL}, {0xa99541bf57452b28ULL, 0x353a1607ac744a53ULL},
+    {0xd3fa922f2d1675f2ULL, 0x42889b8997915ce8ULL}, {0x847c9b5d7c2e09b7ULL, 0x69956135febada11ULL},
+    {0xa59bc234db398c25ULL, 0x43fab9837e699095ULL}, {0xcf02b2c21207ef2eULL, 0x94f967e45e03f4bbULL},
+    {0x8161afb94b44f57dULL, 0x1d1be0eebac278f5ULL}, {0xa1ba1ba79e1632dcULL, 0x6462d92a69731732ULL},
+    {0xca28a291859bbf93ULL, 0x7d7b8f7503cfdcfeULL}, {0xfcb2cb35e702af78ULL, 0x5cda735244c3d43eULL},
+    {0x9defbf01b061adabULL, 0x3a0888136afa64a7ULL}, {0xc56baec21c7a1916ULL, 0x088aaa1845b8fdd0ULL},
+    {0xf6c69a72a3989f5bULL, 0x8aad549e57273d45ULL}, {0x9a3c2087a63f6399ULL, 0x36ac54e2f678864bULL},
+    {0xc0cb28a98fcf3c7fULL, 0x84576a1bb416a7ddULL}, {0xf0fdf2d3f3c30b9fULL, 0x656d44a2a11c51d5ULL},
+    {0x969eb7c47859e743ULL, 0x9f644ae5a4b1b325ULL}, {0xbc4665b596706114ULL, 0x873d5d9f0dde1feeULL},
+    {0xeb57ff22fc0c7959ULL, 0xa90cb506d155a7eaULL}, {0x9316ff75dd87cbd8ULL, 0x09a7f12442d588f2ULL},
+    {0xb7dcbf5354e9beceULL, 0x0c11ed6d538aeb2fULL}, {0xe5d3ef282a242e81ULL, 0x8f1668c8a86da5faULL},
+    {0x8fa475791a569d10ULL, 0xf96e017d694487bcULL}, {0xb38d92d760ec4455ULL, 0x37c981dcc395a9acULL},
+    {0xe070f78d3927556aULL, 0x85bbe253f47b1417ULL}, {0x8c469ab843b89562ULL, 0x93956d7478ccec8eULL},
+    {0xaf58416654a6babbULL, 0x387ac8d1970027b2ULL}, {0xdb2e51bfe9d0696aULL, 0x06997b05fcc0319eULL},
+    {0x88fcf317f22241e2ULL, 0x441fece3bdf81f03ULL}, {0xab3c2fddeeaad25aULL, 0xd527e81cad7626c3ULL},
+    {0xd60b3bd56a5586f1ULL, 0x8a71e223d8d3b074ULL}, {0x85c7056562757456ULL, 0xf6872d5667844e49ULL},
+    {0xa738c6bebb12d16cULL, 0xb428f8ac016561dbULL}, {0xd106f86e69d785c7ULL, 0xe13336d701beba52ULL},
+    {0x82a45b450226b39cULL, 0xecc0024661173473ULL}, {0xa34d721642b06084ULL, 0x27f002d7f95d0190ULL},
+    {0xcc20ce9bd35c78a5ULL, 0x31ec038df7b441f4ULL}, {0xff290242c83396ceULL, 0x7e67047175a15271ULL},
+    {0x9f79a169bd203e41ULL, 0x0f0062c6e984d386ULL}, {0xc75809c42c684dd1ULL, 0x52c07b78a3e60868ULL},
+    {0xf92e0c3537826145ULL, 0xa7709a56ccdf8a82ULL}, {0x9bbcc7a142b17ccbULL, 0x88a66076400bb691ULL},
+    {0xc2abf989935ddbfeULL, 0x6acff893d00ea435ULL}, {0xf356f7ebf83552feULL, 0x0583f6b8c4124d43ULL},
+    {0x98165af37b2153deULL, 0xc3727a337a8b704aULL}, {0xbe1bf1b059e9a8d6ULL, 0x744f18c0592e4c5cULL},
+    {0xeda2ee1c7064130cULL, 0x1162def06f79df73ULL}, {0x9485d4d1c63e8be7ULL, 0x8addcb5645ac2ba8ULL},
+    {0xb9a74a0637ce2ee1ULL, 0x6d953e2bd7173692ULL}, {0xe8111c87c5c1ba99ULL, 0xc8fa8db6ccdd0437ULL},
+    {0x910ab1d4db9914a0ULL, 0x1d9c9892400a22a2ULL}, {0xb54d5e4a127f59c8ULL, 0x2503beb6d00cab4bULL},
+    {0xe2a0b5dc971f303aULL, 0x2e44ae64840fd61dULL}, {0x8da471a9de737e24ULL, 0x5ceaecfed289e5d2ULL},
+    {0xb10d8e1456105dadULL, 0x7425a83e872c5f47ULL}, {0xdd50f1996b947518ULL, 0xd12f124e28f77719ULL},
+    {0x8a5296ffe33cc92fULL, 0x82bd6b70d99aaa6fULL}, {0xace73cbfdc0bfb7bULL, 0x636cc64d1001550bULL},
+    {0xd8210befd30efa5aULL, 0x3c47f7e05401aa4eULL}, {0x8714a775e3e95c78ULL, 0x65acfaec34810a71ULL},
+    {0xa8d9d1535ce3b396ULL, 0x7f1839a741a14d0dULL}, {0xd31045a8341ca07cULL, 0x1ede48111209a050ULL},
+    {0x83ea2b892091e44dULL, 0x934aed0aab460432ULL}, {0xa4e4b66b68b65d60ULL, 0xf81da84d5617853fULL},
+    {0xce1de40642e3f4b9ULL, 0x36251260ab9d668eULL}, {0x80d2ae83e9ce78f3ULL, 0xc1d72b7c6b426019ULL},
+    {0xa1075a24e4421730ULL, 0xb24cf65b8612f81fULL}, {0xc94930ae1d529cfcULL, 0xdee033f26797b627ULL},
+    {0xfb9b7cd9a4a7443cULL, 0x169840ef017da3b1ULL}, {0x9d412e0806e88aa5ULL, 0x8e1f289560ee864eULL},
+    {0xc491798a08a2ad4eULL, 0xf1a6f2bab92a27e2ULL}, {0xf5b5d7ec8acb58a2ULL, 0xae10af696774b1dbULL},
+    {0x9991a6f3d6bf1765ULL, 0xacca6da1e0a8ef29ULL}, {0xbff610b0cc6edd3fULL, 0x17fd090a58d32af3ULL},
+    {0xeff394dcff8a948eULL, 0xddfc4b4cef07f5b0ULL}, {0x95f83d0a1fb69cd9ULL, 0x4abdaf101564f98eULL},
+    {0xbb764c4ca7a4440fULL, 0x9d6d1ad41abe37f1ULL}, {0xea53df5fd18d5513ULL, 0x84c86189216dc5edULL},
+    {0x92746b9be2f8552cULL, 0x32fd3cf5b4e49bb4ULL}, {0xb7118682dbb66a77ULL, 0x3fbc8c33221dc2a1ULL},
+    {0xe4d5e82392a40515ULL, 0x0fabaf3feaa5334aULL}, {0x8f05b1163ba6832dULL, 0x29cb4d87f2a7400eULL},
+    {0xb2c71d5bca9023f8ULL, 0x743e20e9ef511012ULL}, {0xdf78e4b2bd342cf6ULL, 0x914da9246b255416ULL},
+    {0x8bab8eefb6409c1aULL, 0x1ad089b6c2f7548eULL}, {0xae9672aba3d0c320ULL, 0xa184ac2473b529b1ULL},
+    {0xda3c0f568cc4f3e8ULL, 0xc9e5d72d90a2741eULL}, {0x8865899617fb1871ULL, 0x7e2fa67c7a658892ULL},
+    {0xaa7eebfb9df9de8dULL, 0xddbb901b98feeab7ULL}, {0xd51ea6fa85785631ULL, 0x552a74227f3ea565ULL},
+    {0x8533285c936b35deULL, 0xd53a88958f87275fULL}, {0xa67ff273b8460356ULL, 0x8a892abaf368f137ULL},
+    {0xd01fef10a657842cULL, 0x2d2b7569b0432d85ULL}, {0x8213f56a67f6b29bULL, 0x9c3b29620e29fc73ULL},
+    {0xa298f2c501f45f42ULL, 0x8349f3ba91b47b8fULL}, {0xcb3f2f7642717713ULL, 0x241c70a936219a73ULL},
+    {0xfe0efb53d30dd4d7ULL, 0xed238cd383aa0110ULL}, {0x9ec95d1463e8a506ULL, 0xf4363804324a40aaULL},
+    {0xc67bb4597ce2ce48ULL, 0xb143c6053edcd0d5ULL}, {0xf81aa16fdc1b81daULL, 0xdd94b7868e94050aULL},
+    {0x9b10a4e5e9913128ULL, 0xca7cf2b4191c8326ULL}, {0xc1d4ce1f63f57d72ULL, 0xfd1c2f611f63a3f0ULL},
+    {0xf24a01a73cf2dccfULL, 0xbc633b39673c8cecULL}, {0x976e41088617ca01ULL, 0xd5be0503e085d813ULL},
+    {0xbd49d14aa79dbc82ULL, 0x4b2d8644d8a74e18ULL}, {0xec9c459d51852ba2ULL, 0xddf8e7d60ed1219eULL},
+    {0x93e1ab8252f33b45ULL, 0xcabb90e5c942b503ULL}, {0xb8da1662e7b00a17ULL, 0x3d6a751f3b936243ULL},
+    {0xe7109bfba19c0c9dULL, 0x0cc512670a783ad4ULL}, {0x906a617d450187e2ULL, 0x27fb2b80668b24c5ULL},
+    {0xb484f9dc9641e9daULL, 0xb1f9f660802dedf6ULL}, {0xe1a63853bbd26451ULL, 0x5e7873f8a0396973ULL},
+    {0x8d07e33455637eb2ULL, 0xdb0b487b6423e1e8ULL}, {0xb049dc016abc5e5fULL, 0x91ce1a9a3d2cda62ULL},
+    {0xdc5c5301c56b75f7ULL, 0x7641a140cc7810fbULL}, {0x89b9b3e11b6329baULL, 0xa9e904c87fcb0a9dULL},
+    {0xac2820d9623bf429ULL, 0x546345fa9fbdcd44ULL}, {0xd732290fbacaf133ULL, 0xa97c177947ad4095ULL},
+    {0x867f59a9d4bed6c0ULL, 0x49ed8eabcccc485dULL}, {0xa81f301449ee8c70ULL, 0x5c68f256bfff5a74ULL},
+    {0xd226fc195c6a2f8cULL, 0x73832eec6fff3111ULL}, {0x83585d8fd9c25db7ULL, 0xc831fd53c5ff7eabULL},
+    {0xa42e74f3d032f525ULL, 0xba3e7ca8b77f5e55ULL}, {0xcd3a1230c43fb26fULL, 0x28ce1bd2e55f35ebULL},
+    {0x80444b5e7aa7cf85ULL, 0x7980d163cf5b81b3ULL}, {0xa0555e361951c366ULL, 0xd7e105bcc332621fULL},
+    {0xc86ab5c39fa63440ULL, 0x8dd9472bf3fefaa7ULL}, {0xfa856334878fc150ULL, 0xb14f98f6f0feb951ULL},
+    {0x9c935e00d4b9d8d2ULL, 0x6ed1bf9a569f33d3ULL}, {0xc3b8358109e84f07ULL, 0x0a862f80ec4700c8ULL},
+    {0xf4a642e14c6262c8ULL, 0xcd27bb612758c0faULL}, {0x98e7e9cccfbd7dbdULL, 0x8038d51cb897789cULL},
+    {0xbf21e44003acdd2cULL, 0xe0470a63e6bd56c3ULL}, {0xeeea5d5004981478ULL, 0x1858ccfce06cac74ULL},
+    {0x95527a5202df0ccbULL, 0x0f37801e0c43ebc8ULL}, {0xbaa718e68396cffdULL, 0xd30560258f54e6baULL},
+    {0xe950df20247c83fdULL, 0x47c6b82ef32a2069ULL}, {0x91d28b7416cdd27eULL, 0x4cdc331d57fa5441ULL},
+    {0xb6472e511c81471dULL, 0xe0133fe4adf8e952ULL}, {0xe3d8f9e563a198e5ULL, 0x58180fddd97723a6ULL},
+    {0x8e679c2f5e44ff8fULL, 0x570f09eaa7ea7648ULL},
+};
+
+// exactly representable powers of ten
+static const double CJ5__POW10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// Eisel-Lemire: computes the bits of the double closest to w*10^q
+// returns false in rare cases that the result can't be decided with 128-bit precision
+static bool cj5__eisel_lemire(uint64_t w, int q, uint64_t* obits)
+{
+    if (w == 0 || q < CJ5__POW5_MIN) {
+        *obits = 0;
+        return true;
+    }
+    if (q > CJ5__POW5_MAX) {
+        *obits = 0x7FF0000000000000ull;
+        return true;
+    }
+
+    int lz = cj5__clz64(w);
+    w <<= lz;
+
+    const uint64_t* pow5 = CJ5__POW5_128[q - CJ5__POW5_MIN];
+    uint64_t hi;
+    uint64_t lo = cj5__mul128(w, pow5[0], &hi);
+    if ((hi & 0x1FF) == 0x1FF) {
+        // the lower bits may change the rounding, add the second half of the product
+        uint64_t hi2;
+        cj5__mul128(w, pow5[1], &hi2);
+        lo += hi2;
+        if (hi2 > lo) {
+            ++hi;
+        }
+    }
+    if (lo == 0xFFFFFFFFFFFFFFFFull && (q < -27 || q > 55)) {
+        return false;
+    }
+
+    // keep 54 bits (52 bits mantissa + implicit bit + rounding bit)
+    int upperbit = (int)(hi >> 63);
+    uint64_t mantissa = hi >> (upperbit + 9);
+    int power2 = (((152170 + 65536) * q) >> 16) + 63 + upperbit - lz + 1023;
+
+    if (power2 <= 0) {
+        // subnormal
+        if (-power2 + 1 >= 64) {
+            *obits = 0;
+            return true;
+        }
+        mantissa >>= -power2 + 1;
+        mantissa += mantissa & 1;
+        mantissa >>= 1;
+        power2 = mantissa < (1ull << 52) ? 0 : 1;
+        *obits = mantissa | ((uint64_t)power2 << 52);
+        return true;
+    }
+
+    // exactly halfway between two doubles: round to even
+    if (lo <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1 &&
+        (mantissa << (upperbit + 9)) == hi) {
+        mantissa &= ~(uint64_t)1;
+    }
+
+    mantissa += mantissa & 1;
+    mantissa >>= 1;
+    if (mantissa >= (2ull << 52)) {
+        mantissa = 1ull << 52;
+        ++power2;
+    }
+    mantissa &= ~(1ull << 52);
+
+    if (power2 >= 0x7FF) {
+        *obits = 0x7FF0000000000000ull;
+        return true;
+    }
+
+    *obits = mantissa | ((uint64_t)power2 << 52);
+    return true;
+}
+
+#        if CJ5__LITTLE_ENDIAN
+// SWAR: converts 8 ascii digits at once, `v` is loaded from memory (little-endian)
+static inline uint64_t cj5__parse_8digits(uint64_t v)
+{
+    v -= 0x3030303030303030ull;
+    v = (v * 10) + (v >> 8);
+    return (((v & 0x000000FF000000FFull) * (100 + (1000000ull << 32))) +
+            (((v >> 16) & 0x000000FF000000FFull) * (1 + (10000ull << 32)))) >> 32;
+}
+#        endif
+
+// accumulates decimal digits into `value` (can wrap around), returns the first non-digit
+static inline const char* cj5__parse_digits(const char* p, const char* end, uint64_t* value)
+{
+    uint64_t v = *value;
+#        if CJ5__LITTLE_ENDIAN
+    static const uint64_t pow10[] = { 1, 10, 100, 1000, 10000, 100000, 1000000, 10000000 };
+    while (end - p >= 8) {
+        uint64_t digits8;
+        CJ5_MEMCPY(&digits8, p, 8);
+
+        // high bit of every byte that is not a digit: (c ^ '0') >= 10
+        uint64_t x = digits8 ^ 0x3030303030303030ull;
+        uint64_t non_digits =
+            (((x & 0x7F7F7F7F7F7F7F7Full) + 0x7676767676767676ull) | x) & 0x8080808080808080ull;
+        if (non_digits == 0) {
+            v = v * 100000000 + cj5__parse_8digits(digits8);
+            p += 8;
+            continue;
+        }
+
+        // less than 8 digits: shift them to the end and pad with leading '0's
+        int n = cj5__ctz64(non_digits) >> 3;
+        if (n > 0) {
+            digits8 = (digits8 << (8 * (8 - n))) | (0x3030303030303030ull >> (8 * n));
+            v = v * pow10[n] + cj5__parse_8digits(digits8);
+            p += n;
+        }
+        *value = v;
+        return p;
+    }
+#        endif
+    for (; p < end && cj5__isnum(*p); p++) {
+        v = v * 10 + (uint64_t)(*p - '0');
+    }
+    *value = v;
+    return p;
+}
+
+// slow path, for numbers that Eisel-Lemire can't decide. the number is passed to strtod as
+// integer digits and an exponent, so the decimal point of the current locale doesn't matter.
+// 768 significant digits are enough to round correctly, the rest are replaced by a nonzero digit
+// if any of them is nonzero
+#        define CJ5__STRTOD_MAX_DIGITS 768
+static double cj5__strtod(const char* str, const char* end)
+{
+    char snum[CJ5__STRTOD_MAX_DIGITS + 32];
+    int len = 0;
+    const char* p = str;
+    if (p < end && (*p == '-' || *p == '+')) {
+        snum[len++] = *p++;
+    }
+
+    cj5_int exp10 = 0;
+    int num_digits = 0;
+    bool fraction = false;
+    bool sticky = false;
+    for (; p < end && (cj5__isnum(*p) || *p == '.'); p++) {
+        if (*p == '.') {
+            fraction = true;
+            continue;
+        }
+        exp10 -= fraction ? 1 : 0;
+        if (num_digits == 0 && *p == '0') {
+            continue;    // leading zeros are not significant
+        }
+        if (num_digits < CJ5__STRTOD_MAX_DIGITS) {
+            snum[len++] = *p;
+            num_digits++;
+        } else {
+            sticky |= *p != '0';
+            exp10++;
+        }
+    }
+    if (sticky) {
+        snum[len++] = '1';
+        exp10--;
+    } else if (num_digits == 0) {
+        snum[len++] = '0';
+    }
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool exp_negative = p < end && *p == '-';
+        p += p < end && (*p == '-' || *p == '+') ? 1 : 0;
+        cj5_int e = 0;
+        for (; p < end && cj5__isnum(*p); p++) {
+            if (e < 100000) {
+                e = e * 10 + (*p - '0');
+            }
+        }
+        exp10 += exp_negative ? -e : e;
+    }
+
+    // far out of range either way, keeps the exponent short
+    exp10 = exp10 < -200000 ? -200000 : (exp10 > 200000 ? 200000 : exp10);
+    snum[len++] = 'e';
+    if (exp10 < 0) {
+        snum[len++] = '-';
+        exp10 = -exp10;
+    }
+    char exp_digits[8];
+    int num_exp_digits = 0;
+    do {
+        exp_digits[num_exp_digits++] = (char)('0' + exp10 % 10);
+        exp10 /= 10;
+    } while (exp10 > 0);
+    while (num_exp_digits > 0) {
+        snum[len++] = exp_digits[--num_exp_digits];
+    }
+    snum[len] = '\0';
+    return strtod(snum, NULL);
+}
+
+static double cj5__todouble(const char* str, const char* end)
+{
+    const char* p = str;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        p++;
+    }
+
+    // the number is w*10^exp10, `w` overflows for more than 19 digits, which is handled below
+    uint64_t w = 0;
+    const char* digits = p;
+    p = cj5__parse_digits(p, end, &w);
+    int num_digits = (int)(p - digits);
+    int exp10 = 0;
+
+    if (p < end && *p == '.') {
+        const char* fraction = ++p;
+        p = cj5__parse_digits(p, end, &w);
+        exp10 = -(int)(p - fraction);
+        num_digits += (int)(p - fraction);
+    }
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool exp_negative = false;
+        if (p < end && (*p == '-' || *p == '+')) {
+            exp_negative = *p == '-';
+            p++;
+        }
+        int e = 0;
+        for (; p < end && cj5__isnum(*p); p++) {
+            if (e < 100000) {
+                e = e * 10 + (*p - '0');
+            }
+        }
+        exp10 += exp_negative ? -e : e;
+    }
+
+    bool truncated = false;
+    if (num_digits > 19) {
+        // leading zeros are not significant
+        const char* s = digits;
+        for (; s < end && (*s == '0' || *s == '.'); s++) {
+            num_digits -= *s == '0';
+        }
+
+        if (num_digits > 19) {
+            // keep the first 19 significant digits, the rest only affects the exponent
+            w = 0;
+            int count = 0;
+            for (; s < end && (cj5__isnum(*s) || *s == '.'); s++) {
+                if (*s == '.') {
+                    continue;
+                }
+                if (count++ < 19) {
+                    w = w * 10 + (uint64_t)(*s - '0');
+                } else {
+                    truncated |= *s != '0';
+                }
+            }
+            exp10 += num_digits - 19;
+        }
+    }
+
+    double num;
+    if (!truncated && w <= (1ull << 53) && exp10 >= -22 && exp10 <= 22) {
+        // Clinger's fast path: mantissa and the power of ten are both exact, so is the result
+        num = (double)w;
+        num = exp10 < 0 ? num / CJ5__POW10[-exp10] : num * CJ5__POW10[exp10];
+    } else {
+        uint64_t bits, bits_up;
+        // truncated digits: the result is between w and w+1, it's only valid if both round the same
+        if (!cj5__eisel_lemire(w, exp10, &bits) ||
+            (truncated && (!cj5__eisel_lemire(w + 1, exp10, &bits_up) || bits != bits_up))) {
+            return cj5__strtod(str, end);
+        }
+        CJ5_MEMCPY(&num, &bits, sizeof(num));
+    }
+
+    return negative ? -num : num;
+}
+
+// decodes decimal digits until the first non-digit, returns false if it doesn't fit in 64 bits
+static bool cj5__dectou64(const char* str, const char* end, uint64_t* ovalue)
+{
+    const char* p = str;
+    while (p < end && *p == '0') {
+        p++;
+    }
+
+    const char* digits = p;
+    uint64_t value = 0;
+    p = cj5__parse_digits(p, end, &value);
+
+    int num_digits = (int)(p - digits);
+    if (num_digits == 20) {
+        // UINT64_MAX has 20 digits, so the value may have wrapped around. compare the first 19
+        // digits with 1844674407370955161 and the last one with 5
+        uint64_t head = 0;
+        for (int i = 0; i < 19; i++) {
+            head = head * 10 + (uint64_t)(digits[i] - '0');
+        }
+        if (head > 1844674407370955161ull || (head == 1844674407370955161ull && digits[19] > '5')) {
+            return false;
+        }
+    }
+
+    *ovalue = value;
+    return num_digits <= 20;
+}
+
+static uint64_t cj5__hextou64(const char* str, const char* end)
+{
+    uint64_t num = 0;
+    for (const char* p = str; p < end; p++) {
+        char c = *p;
+        num = (num << 4) | (uint64_t)(c <= '9' ? c - '0' : (c | 0x20) - 'a' + 10);
+    }
+    return num;
+}
+
+// decodes a number token into sign and magnitude, floats are truncated. `fraction` (optional) is
+// set if a float had a fractional part that was cut off
+static uint64_t cj5__get_integer(const char* json5, const cj5__tok* tok, bool* negative,
+                                 bool* overflow, bool* fraction)
+{
+    const char* str = &json5[tok->start];
+    const char* end = &json5[tok->end];
+    uint64_t value = 0;
+    *negative = false;
+    *overflow = false;
+
+    if (tok->num_type == CJ5_TOKEN_NUMBER_HEX) {
+        while (str < end && *str == '0') {
+            str++;
+        }
+        *overflow = end - str > 16;
+        value = *overflow ? UINT64_MAX : cj5__hextou64(str, end);
+    } else if (tok->num_type == CJ5_TOKEN_NUMBER_FLOAT) {
+        double num = cj5__todouble(str, end);
+        *negative = num < 0;
+        num = *negative ? -num : num;
+        if (num >= 18446744073709551616.0) {
+            *overflow = true;
+            value = UINT64_MAX;
+        } else if (num == num) {
+            value = (uint64_t)num;
+            if (fraction) {
+                *fraction = (double)value != num;
+            }
+        }
+    } else {
+        if (str < end && *str == '-') {
+            *negative = true;
+            str++;
+        }
+        if (!cj5__dectou64(str, end, &value)) {
+            *overflow = true;
+            value = UINT64_MAX;
+        }
+    }
+
+    return value;
+}
+
+static inline cj5__tok cj5__number_token(cj5_result* r, cj5_int id)
+{
+    cj5__tok tok = cj5__get_tok(r, id);
+    CJ5_ASSERT(tok.type == CJ5_TOKEN_NUMBER);
+    return tok;
+}
+
+// clamps sign and magnitude to [-max_val-1, max_val], `overflow` is in/out
+static int64_t cj5__clamp_signed(uint64_t value, bool negative, int64_t max_val, bool* overflow)
+{
+    if (negative) {
+        if (*overflow || value > (uint64_t)max_val + 1) {
+            *overflow = true;
+            return -max_val - 1;
+        }
+        return value == 0 ? 0 : -(int64_t)(value - 1) - 1;
+    }
+
+    if (*overflow || value > (uint64_t)max_val) {
+        *overflow = true;
+        return max_val;
+    }
+    return (int64_t)value;
+}
+
+// clamps sign and magnitude to [0, max_val], `overflow` is in/out
+static uint64_t cj5__clamp_unsigned(uint64_t value, bool negative, uint64_t max_val, bool* overflow)
+{
+    if (negative && value != 0) {
+        *overflow = true;
+        return 0;
+    }
+
+    if (*overflow || value > max_val) {
+        *overflow = true;
+        return max_val;
+    }
+    return value;
+}
+
+cj5_int cj5_seek_recursive(cj5_result* r, cj5_int parent_id, const char* key)
+{
+    CJ5_ASSERT(parent_id >= 0 && parent_id < r->num_tokens);
+
+    uint32_t key_hash = cj5__hash_fnv32(key, key + cj5__strlen(key));
+    return cj5__seek_recursive(r, parent_id, key_hash);
+}
+
+cj5_int cj5_seek_hash(cj5_result* r, cj5_int parent_id, const uint32_t key_hash)
+{
+    CJ5_ASSERT(parent_id >= 0 && parent_id < r->num_tokens);
+    cj5_int end = cj5__next(r, parent_id);
+
+    // an indexed object has at least CJ5_INDEX_MIN_KEYS keys and their values after it
+    if (r->index && end - parent_id > 2 * CJ5_INDEX_MIN_KEYS &&
+        cj5_get_type(r, parent_id) == CJ5_TOKEN_OBJECT) {
+        const cj5__index_table* table = cj5__index_find((const cj5__index*)r->index, parent_id);
+        if (table) {
+            for (cj5_int slot = (cj5_int)(key_hash & (uint32_t)table->mask);
+                 table->slots[slot] != -1;
+                 slot = (slot + 1) & table->mask) {
+                cj5_int key_id = table->slots[slot];
+                if (cj5__key_hash(r, key_id) == key_hash) {
+                    return key_id + 1;
+                }
+            }
+            return -1;
+        }
+    }
+
+    for (cj5_int i = parent_id + 1; i < end; i = cj5__next(r, i)) {
+        if (key_hash == cj5__key_hash(r, i) && cj5__is_key(r, i)) {
+            CJ5_ASSERT((i + 1) < r->num_tokens);
+            return i + 1;    // return next "value" token (array/objects and primitive values)
+        }
+    }
+
+    return -1;
+}
+
+static cj5_int cj5__index_num_keys(cj5_result* r, cj5_int id)
+{
+    // objects with fewer tokens than this can't have enough keys, skip counting them
+    cj5_int end = cj5__next(r, id);
+    if (end - id <= 2 * CJ5_INDEX_MIN_KEYS || cj5_get_type(r, id) != CJ5_TOKEN_OBJECT) {
+        return 0;
+    }
+    if (!r->compact) {
+        return r->tokens[id].size;
+    }
+
+    cj5_int num_keys = 0;
+    for (cj5_int i = id + 1; i < end; i = cj5__next(r, i)) {
+        num_keys++;
+    }
+    return num_keys;
+}
+
+cj5_int cj5_build_index(cj5_result* r, void* mem, cj5_int mem_size)
+{
+    // count the tables and slots we need
+    cj5_int num_tables = 0;
+    cj5_int num_slots = 0;
+    for (cj5_int i = 0; i < r->num_tokens; i++) {
+        cj5_int num_keys = cj5__index_num_keys(r, i);
+        if (num_keys >= CJ5_INDEX_MIN_KEYS) {
+            num_tables++;
+            num_slots += cj5__index_num_slots(num_keys);
+        }
+    }
+
+    const cj5_int tables_offset =
+        (cj5_int)((sizeof(cj5__index) + sizeof(void*) - 1) & ~(sizeof(void*) - 1));
+    const cj5_int slots_offset = tables_offset + num_tables * (cj5_int)sizeof(cj5__index_table);
+    const cj5_int total_size = slots_offset + num_slots * (cj5_int)sizeof(cj5_int);
+    if (mem == NULL || mem_size < total_size) {
+        return total_size;
+    }
+    CJ5_ASSERT(((uintptr_t)mem & (sizeof(void*) - 1)) == 0);
+
+    cj5__index* index = (cj5__index*)mem;
+    index->num_tables = num_tables;
+    index->tables = (cj5__index_table*)((uint8_t*)mem + tables_offset);
+    cj5_int* slots = (cj5_int*)((uint8_t*)mem + slots_offset);
+    CJ5_MEMSET(slots, 0xff, (size_t)num_slots * sizeof(cj5_int));
+
+    cj5__index_table* table = index->tables;
+    for (cj5_int i = 0; i < r->num_tokens; i++) {
+        cj5_int num_keys = cj5__index_num_keys(r, i);
+        if (num_keys < CJ5_INDEX_MIN_KEYS) {
+            continue;
+        }
+
+        table->object_id = i;
+        table->mask = cj5__index_num_slots(num_keys) - 1;
+        table->slots = slots;
+        slots += table->mask + 1;
+
+        // keys are inserted in order, so duplicate hashes resolve to the first key like a linear scan
+        for (cj5_int k = i + 1, end = cj5__next(r, i); k < end; k = cj5__next(r, k)) {
+            if (!cj5__is_key(r, k)) {
+                continue;
+            }
+
+            cj5_int slot = (cj5_int)(cj5__key_hash(r, k) & (uint32_t)table->mask);
+            while (table->slots[slot] != -1) {
+                slot = (slot + 1) & table->mask;
+            }
+            table->slots[slot] = k;
+        }
+        table++;
+    }
+
+    r->index = index;
+    return total_size;
+}
+
+cj5_int cj5_seek(cj5_result* r, cj5_int parent_id, const char* key)
+{
+    CJ5_ASSERT(parent_id >= 0 && parent_id < r->num_tokens);
+
+    uint32_t key_hash = cj5__hash_fnv32(key, key + cj5__strlen(key));
+
+    return cj5_seek_hash(r, parent_id, key_hash);
+}
+
+bool cj5_compile_path(cj5_path* path, const char* str)
+{
+    const char* p = str;
+    path->num_steps = 0;
+    while (*p) {
+        if (path->num_steps == CJ5_PATH_MAX_STEPS) {
+            return false;
+        }
+
+        cj5_path_step* step = &path->steps[path->num_steps++];
+        if (*p == '[') {
+            p++;
+            if (!cj5__isnum(*p)) {
+                return false;
+            }
+            cj5_int index = 0;
+            while (cj5__isnum(*p)) {
+                if (index > INT32_MAX / 10) {
+                    return false;
+                }
+                index = index * 10 + (*p++ - '0');
+            }
+            if (*p++ != ']') {
+                return false;
+            }
+            step->key_hash = 0;
+            step->index = index;
+        } else {
+            // keys after the first step need a '.'
+            if (path->num_steps > 1 && *p++ != '.') {
+                return false;
+            }
+            const char* key = p;
+            while (*p && *p != '.' && *p != '[') {
+                p++;
+            }
+            if (p == key) {
+                return false;
+            }
+            step->key_hash = cj5__hash_fnv32(key, p);
+            step->index = -1;
+        }
+    }
+    return true;
+}
+
+cj5_int cj5_query(cj5_result* r, cj5_int parent_id, const cj5_path* path)
+{
+    cj5_int id = parent_id;
+    for (int i = 0; i < path->num_steps && id != -1; i++) {
+        const cj5_path_step* step = &path->steps[i];
+        cj5_token_type type = cj5_get_type(r, id);
+        if (step->index != -1) {
+            id = type == CJ5_TOKEN_ARRAY ? cj5_get_array_elem(r, id, step->index) : -1;
+        } else {
+            id = type == CJ5_TOKEN_OBJECT ? cj5_seek_hash(r, id, step->key_hash) : -1;
+        }
+    }
+    return id;
+}
+
+// resolves step `depth` of the paths in `group` from container `id`, then continues with the paths
+// that go to the same child together
+static void cj5__query_group(cj5_result* r, cj5_int id, int depth, const cj5_path* paths,
+                             const int* group, int num_group, cj5_int* ids)
+{
+    cj5_token_type type = cj5_get_type(r, id);
+    if (type != CJ5_TOKEN_OBJECT && type != CJ5_TOKEN_ARRAY) {
+        return;
+    }
+
+    // sort the paths by the key hash (or index) of this step, so every child is a binary search
+    // and the paths that go to the same child are next to each other
+    int pending[CJ5__QUERY_GROUP];
+    uint32_t keys[CJ5__QUERY_GROUP];
+    cj5_int found[CJ5__QUERY_GROUP];
+    int num_pending = 0;
+    for (int g = 0; g < num_group; g++) {
+        const cj5_path_step* step = &paths[group[g]].steps[depth];
+        if ((step->index == -1) != (type == CJ5_TOKEN_OBJECT)) {
+            continue;
+        }
+        uint32_t key = type == CJ5_TOKEN_OBJECT ? step->key_hash : (uint32_t)step->index;
+        int k = num_pending++;
+        for (; k > 0 && keys[k - 1] > key; k--) {
+            keys[k] = keys[k - 1];
+            pending[k] = pending[k - 1];
+        }
+        keys[k] = key;
+        pending[k] = group[g];
+    }
+    for (int k = 0; k < num_pending; k++) {
+        found[k] = -1;
+    }
+
+    if (num_pending > 0 && type == CJ5_TOKEN_OBJECT && r->index &&
+        cj5__index_find((const cj5__index*)r->index, id)) {
+        // indexed objects are usually large, so hash lookups are cheaper than scanning all keys
+        for (int k = 0; k < num_pending; k++) {
+            found[k] = k > 0 && keys[k] == keys[k - 1] ? found[k - 1]
+                                                       : cj5_seek_hash(r, id, keys[k]);
+        }
+    } else {
+        // single pass over the children, the first matching key wins like in `cj5_seek`
+        int num_left = num_pending;
+        for (cj5_int i = id + 1, index = 0, end = cj5__next(r, id); i < end && num_left > 0;
+             i = cj5__next(r, i), index++) {
+            uint32_t key = (uint32_t)index;
+            if (type == CJ5_TOKEN_OBJECT) {
+                if (!cj5__is_key(r, i)) {
+                    continue;
+                }
+                key = cj5__key_hash(r, i);
+            }
+
+            int lo = 0, hi = num_pending;
+            while (lo < hi) {
+                int mid = (lo + hi) >> 1;
+                if (keys[mid] < key) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            for (int k = lo; k < num_pending && keys[k] == key && found[k] == -1; k++) {
+                found[k] = type == CJ5_TOKEN_OBJECT ? i + 1 : i;
+                num_left--;
+            }
+        }
+    }
+
+    int sub[CJ5__QUERY_GROUP];
+    for (int k = 0; k < num_pending;) {
+        cj5_int child_id = found[k];
+        int num_sub = 0;
+        for (; k < num_pending && found[k] == child_id; k++) {
+            if (child_id == -1) {
+                continue;
+            } else if (paths[pending[k]].num_steps == depth + 1) {
+                ids[pending[k]] = child_id;
+            } else {
+                sub[num_sub++] = pending[k];
+            }
+        }
+        if (num_sub > 0) {
+            cj5__query_group(r, child_id, depth + 1, paths, sub, num_sub, ids);
+        }
+    }
+}
+
+void cj5_query_batch(cj5_result* r, cj5_int parent_id, const cj5_path* paths, int num_paths,
+                     cj5_int* ids)
+{
+    CJ5_ASSERT(parent_id >= 0 && parent_id < r->num_tokens);
+
+    int group[CJ5__QUERY_GROUP];
+    for (int first = 0; first < num_paths; first += CJ5__QUERY_GROUP) {
+        int num_group = 0;
+        for (int i = first; i < num_paths && i < first + CJ5__QUERY_GROUP; i++) {
+            ids[i] = paths[i].num_steps == 0 ? parent_id : -1;
+            if (paths[i].num_steps > 0) {
+                group[num_group++] = i;
+            }
+        }
+        if (num_group > 0) {
+            cj5__query_group(r, parent_id, 0, paths, group, num_group, ids);
+        }
+    }
+}
+
+const char* cj5_get_string(cj5_result* r, cj5_int id, char* str, int max_str)
+{
+    cj5__tok tok = cj5__get_tok(r, id);
+    CJ5_ASSERT(tok.type == CJ5_TOKEN_STRING);
+    if (!tok.escaped) {
+        return cj5__strcpy(str, max_str, &r->json5[tok.start], tok.end - tok.start);
+    }
+
+    CJ5_ASSERT(max_str > 0);
+    cj5_int num = cj5_unescape(str, max_str - 1, &r->json5[tok.start], tok.end - tok.start);
+    str[num] = '\0';
+    return str;
+}
+
+const char* cj5_get_string_view(cj5_result* r, cj5_int id, cj5_int* len)
+{
+    cj5__tok tok = cj5__get_tok(r, id);
+    CJ5_ASSERT(tok.type == CJ5_TOKEN_STRING);
+    *len = tok.end - tok.start;
+    return tok.escaped ? NULL : &r->json5[tok.start];
+}
+
+double cj5_get_double(cj5_result* r, cj5_int id)
+{
+    cj5__tok tok = cj5__number_token(r, id);
+    const char* str = &r->json5[tok.start];
+    if (tok.num_type == CJ5_TOKEN_NUMBER_HEX) {
+        return (double)cj5__hextou64(str, &r->json5[tok.end]);
+    }
+    return cj5__todouble(str, &r->json5[tok.end]);
+}
+
+float cj5_get_float(cj5_result* r, cj5_int id)
+{
+    return (float)cj5_get_double(r, id);
+}
+
+int cj5_get_int(cj5_result* r, cj5_int id)
+{
+    return cj5_get_int_checked(r, id, NULL);
+}
+
+uint32_t cj5_get_uint(cj5_result* r, cj5_int id)
+{
+    return cj5_get_uint_checked(r, id, NULL);
+}
+
+uint64_t cj5_get_uint64(cj5_result* r, cj5_int id)
+{
+    return cj5_get_uint64_checked(r, id, NULL);
+}
+
+int64_t cj5_get_int64(cj5_result* r, cj5_int id)
+{
+    return cj5_get_int64_checked(r, id, NULL);
+}
+
+int cj5_get_int_checked(cj5_result* r, cj5_int id, bool* overflow)
+{
+    bool negative, overflow_;
+    cj5__tok tok = cj5__number_token(r, id);
+    uint64_t value = cj5__get_integer(r->json5, &tok, &negative, &overflow_, NULL);
+    int num = (int)cj5__clamp_signed(value, negative, INT32_MAX, &overflow_);
+    if (overflow) {
+        *overflow = overflow_;
+    }
+    return num;
+}
+
+uint32_t cj5_get_uint_checked(cj5_result* r, cj5_int id, bool* overflow)
+{
+    bool negative, overflow_;
+    cj5__tok tok = cj5__number_token(r, id);
+    uint64_t value = cj5__get_integer(r->json5, &tok, &negative, &overflow_, NULL);
+    uint32_t num = (uint32_t)cj5__clamp_unsigned(value, negative, UINT32_MAX, &overflow_);
+    if (overflow) {
+        *overflow = overflow_;
+    }
+    return num;
+}
+
+uint64_t cj5_get_uint64_checked(cj5_result* r, cj5_int id, bool* overflow)
+{
+    bool negative, overflow_;
+    cj5__tok tok = cj5__number_token(r, id);
+    uint64_t value = cj5__get_integer(r->json5, &tok, &negative, &overflow_, NULL);
+    uint64_t num = cj5__clamp_unsigned(value, negative, UINT64_MAX, &overflow_);
+    if (overflow) {
+        *overflow = overflow_;
+    }
+    return num;
+}
+
+int64_t cj5_get_int64_checked(cj5_result* r, cj5_int id, bool* overflow)
+{
+    bool negative, overflow_;
+    cj5__tok tok = cj5__number_token(r, id);
+    uint64_t value = cj5__get_integer(r->json5, &tok, &negative, &overflow_, NULL);
+    int64_t num = cj5__clamp_signed(value, negative, INT64_MAX, &overflow_);
+    if (overflow) {
+        *overflow = overflow_;
+    }
+    return num;
+}
+
+bool cj5_get_bool(cj5_result* r, cj5_int id)
+{
+    cj5__tok tok = cj5__get_tok(r, id);
+    CJ5_ASSERT(tok.type == CJ5_TOKEN_BOOL);
+    CJ5_ASSERT((tok.end - tok.start) >= 4);
+
+    uint32_t fourcc;
+    CJ5_MEMCPY(&fourcc, &r->json5[tok.start], 4);
+    if (fourcc == CJ5__TRUE_FOURCC) {
+        return true;
+    } else if (fourcc == CJ5__FALSE_FOURCC) {
+        return false;
+    } else {
+        CJ5_ASSERT(0);
+        return false;
+    }
+}
+
+double cj5_seekget_double(cj5_result* r, cj5_int parent_id, const char* key, double def_val)
+{
+    cj5_int id = cj5_seek(r, parent_id, key);
+    return id > -1 ? cj5_get_double(r, id) : def_val;
+}
+
+float cj5_seekget_float(cj5_result* r, cj5_int parent_id, const char* key, float def_val)
+{
+    cj5_int id = cj5_seek(r, parent_id, key);
+    return id > -1 ? cj5_get_float(r, id) : def_val;
+}
+
+int cj5_seekget_int(cj5_result* r, cj5_int parent_id, const char* key, int def_val)
+{
+    cj5_int id = cj5_seek(r, parent_id, key);
+    return id > -1 ? cj5_get_int(r, id) : def_val;
+}
+
+uint32_t cj5_seekget_uint(cj5_result* r, cj5_int parent_id, const char* key, uint32_t def_val)
+{
+    cj5_int id = cj5_seek(r, parent_id, key);
+    return id > -1 ? cj5_get_uint(r, id) : def_val;
+}
+
+uint64_t cj5_seekget_uint64(cj5_result* r, cj5_int parent_id, const char* key, uint64_t def_val)
+{
+    cj5_int id = cj5_seek(r, parent_id, key);
+    return id > -1 ? cj5_get_uint64(r, id) : def_val;
+}
+
+int64_t cj5_seekget_int64(cj5_result* r, cj5_int parent_id, const char* key, int64_t def_val)
+{
+    cj5_int id = cj5_seek(r, parent_id, key);
+    return id > -1 ? cj5_get_int64(r, id) : def_val;
+}
+
+bool cj5_seekget_bool(cj5_result* r, cj5_int parent_id, const char* key, bool def_val)
+{
+    cj5_int id = cj5_seek(r, parent_id, key);
+    return id > -1 ? cj5_get_bool(r, id) : def_val;
+}
+
+const char* cj5_seekget_string(cj5_result* r, cj5_int parent_id, const char* key, char* str,
+                               int max_str, const char* def_val)
+{
+    cj5_int id = cj5_seek(r, parent_id, key);
+    return id > -1 ? cj5_get_string(r, id, str, max_str) : def_val;
+}
+
+int cj5_seekget_array_double(cj5_result* r, cj5_int parent_id, const char* key, double* values,
+                             int max_values)
+{
+    cj5_int id = key != NULL ? cj5_seek(r, parent_id, key) : parent_id;
+    return id != -1 ? cj5_get_array_numbers(r, id, CJ5_ARRAY_DOUBLE, values, max_values, NULL) : 0;
+}
+
+int cj5_seekget_array_float(cj5_result* r, cj5_int parent_id, const char* key, float* values,
+                            int max_values)
+{
+    cj5_int id = key != NULL ? cj5_seek(r, parent_id, key) : parent_id;
+    return id != -1 ? cj5_get_array_numbers(r, id, CJ5_ARRAY_FLOAT, values, max_values, NULL) : 0;
+}
+
+int cj5_seekget_array_int16(cj5_result* r, cj5_int parent_id, const char* key, int16_t* values,
+                            int max_values)
+{
+    cj5_int id = key != NULL ? cj5_seek(r, parent_id, key) : parent_id;
+    return id != -1 ? cj5_get_array_numbers(r, id, CJ5_ARRAY_INT16, values, max_values, NULL) : 0;
+}
+
+int cj5_seekget_array_uint16(cj5_result* r, cj5_int parent_id, const char* key, uint16_t* values,
+                             int max_values)
+{
+    cj5_int id = key != NULL ? cj5_seek(r, parent_id, key) : parent_id;
+    return id != -1 ? cj5_get_array_numbers(r, id, CJ5_ARRAY_UINT16, values, max_values, NULL) : 0;
+}
+
+
+int cj5_seekget_array_int(cj5_result* r, cj5_int parent_id, const char* key, int* values,
+                          int max_values)
+{
+    cj5_int id = key != NULL ? cj5_seek(r, parent_id, key) : parent_id;
+    return id != -1 ? cj5_get_array_numbers(r, id, CJ5_ARRAY_INT, values, max_values, NULL) : 0;
+}
+
+int cj5_seekget_array_uint(cj5_result* r, cj5_int parent_id, const char* key, uint32_t* values,
+                           int max_values)
+{
+    cj5_int id = key != NULL ? cj5_seek(r, parent_id, key) : parent_id;
+    return id != -1 ? cj5_get_array_numbers(r, id, CJ5_ARRAY_UINT, values, max_values, NULL) : 0;
+}
+
+int cj5_seekget_array_uint64(cj5_result* r, cj5_int parent_id, const char* key, uint64_t* values,
+                             int max_values)
+{
+    cj5_int id = key != NULL ? cj5_seek(r, parent_id, key) : parent_id;
+    return id != -1 ? cj5_get_array_numbers(r, id, CJ5_ARRAY_UINT64, values, max_values, NULL) : 0;
+}
+
+int cj5_seekget_array_int64(cj5_result* r, cj5_int parent_id, const char* key, int64_t* values,
+                            int max_values)
+{
+    cj5_int id = key != NULL ? cj5_seek(r, parent_id, key) : parent_id;
+    return id != -1 ? cj5_get_array_numbers(r, id, CJ5_ARRAY_INT64, values, max_values, NULL) : 0;
+}
+
+int cj5_seekget_array_bool(cj5_result* r, cj5_int parent_id, const char* key, bool* values,
+                           int max_values)
+{
+    cj5_int id = key != NULL ? cj5_seek(r, parent_id, key) : parent_id;
+    if (id != -1) {
+        CJ5_ASSERT(cj5_get_type(r, id) == CJ5_TOKEN_ARRAY);
+        int count = 0;
+        for (cj5_int i = id + 1, end = cj5__next(r, id); i < end && count < max_values;
+             i = cj5__next(r, i)) {
+            values[count++] = cj5_get_bool(r, i);
+        }
+        return count;
+    } else {
+        return 0;
+    }
+}
+
+int cj5_seekget_array_string(cj5_result* r, cj5_int parent_id, const char* key, char** strs,
+                             int max_str, int max_values)
+{
+    cj5_int id = key != NULL ? cj5_seek(r, parent_id, key) : parent_id;
+    if (id != -1) {
+        CJ5_ASSERT(cj5_get_type(r, id) == CJ5_TOKEN_ARRAY);
+        int count = 0;
+        for (cj5_int i = id + 1, end = cj5__next(r, id); i < end && count < max_values;
+             i = cj5__next(r, i)) {
+            cj5_get_string(r, i, strs[count++], max_str);
+        }
+        return count;
+    } else {
+        return 0;
+    }
+}
+
+int cj5_get_array_numbers(cj5_result* r, cj5_int id, cj5_array_type type, void* values,
+                          int max_values, int* invalid_index)
+{
+    CJ5_ASSERT(cj5_get_type(r, id) == CJ5_TOKEN_ARRAY);
+    // numbers don't have children, so the elements are next to each other until the first
+    // non-number element, and that's where we stop anyway. so the subtree size is enough as the
+    // bound, and the number of elements doesn't need to be known
+    cj5_int num_tokens = cj5__next(r, id) - id - 1;
+    int count = num_tokens < max_values ? (int)num_tokens : max_values;
+
+    int first_invalid = -1;
+    int i;
+    for (i = 0; i < count; i++) {
+        cj5__tok elem = cj5__get_tok(r, id + 1 + i);
+        if (elem.type != CJ5_TOKEN_NUMBER) {
+            break;
+        }
+
+        if (type == CJ5_ARRAY_DOUBLE || type == CJ5_ARRAY_FLOAT) {
+            const char* str = &r->json5[elem.start];
+            const char* end = &r->json5[elem.end];
+            double num = elem.num_type == CJ5_TOKEN_NUMBER_HEX ? (double)cj5__hextou64(str, end)
+                                                               : cj5__todouble(str, end);
+            if (type == CJ5_ARRAY_DOUBLE) {
+                ((double*)values)[i] = num;
+            } else {
+                ((float*)values)[i] = (float)num;
+            }
+            continue;
+        }
+
+        bool negative, overflow, fraction = false;
+        uint64_t value = cj5__get_integer(r->json5, &elem, &negative, &overflow, &fraction);
+        switch (type) {
+        case CJ5_ARRAY_INT16:
+            ((int16_t*)values)[i] = (int16_t)cj5__clamp_signed(value, negative, INT16_MAX, &overflow);
+            break;
+        case CJ5_ARRAY_UINT16:
+            ((uint16_t*)values)[i] =
+                (uint16_t)cj5__clamp_unsigned(value, negative, UINT16_MAX, &overflow);
+            break;
+        case CJ5_ARRAY_INT:
+            ((int*)values)[i] = (int)cj5__clamp_signed(value, negative, INT32_MAX, &overflow);
+            break;
+        case CJ5_ARRAY_UINT:
+            ((uint32_t*)values)[i] =
+                (uint32_t)cj5__clamp_unsigned(value, negative, UINT32_MAX, &overflow);
+            break;
+        case CJ5_ARRAY_INT64:
+            ((int64_t*)values)[i] = cj5__clamp_signed(value, negative, INT64_MAX, &overflow);
+            break;
+        case CJ5_ARRAY_UINT64:
+            ((uint64_t*)values)[i] = cj5__clamp_unsigned(value, negative, UINT64_MAX, &overflow);
+            break;
+        default:
+            CJ5_ASSERT(0);
+            break;
+        }
+
+        if ((overflow || fraction) && first_invalid == -1) {
+            first_invalid = i;
+        }
+    }
+
+    if (i < count && first_invalid == -1) {
+        first_invalid = i;
+    }
+    if (invalid_index) {
+        *invalid_index = first_invalid;
+    }
+    return i;
+}
+
+cj5_int cj5_get_array_elem(cj5_result* r, cj5_int id, cj5_int index)
+{
+    CJ5_ASSERT(cj5_get_type(r, id) == CJ5_TOKEN_ARRAY);
+    for (cj5_int i = id + 1, count = 0, end = cj5__next(r, id); i < end;
+         i = cj5__next(r, i), count++) {
+        if (count == index) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+cj5_int cj5_get_array_elem_incremental(cj5_result* r, cj5_int id, cj5_int index, cj5_int prev_elem)
+{
+    CJ5_ASSERT(cj5_get_type(r, id) == CJ5_TOKEN_ARRAY);
+    CJ5__UNUSED(index);
+    // the sibling after the previous element is still an element if it's in the array's subtree
+    cj5_int i = prev_elem <= 0 ? (id + 1) : cj5__next(r, prev_elem);
+    return i < cj5__next(r, id) ? i : -1;
+}
+
+typedef struct cj5__schema_slot {
+    uint32_t key_hash;
+    int field;          // index in `fields`, -1 for empty slots
+} cj5__schema_slot;
+
+cj5_int cj5_schema_init(cj5_schema* schema, const cj5_field* fields, int num_fields, void* mem,
+                        cj5_int mem_size)
+{
+    if (num_fields > CJ5_SCHEMA_MAX_FIELDS) {
+        return -1;
+    }
+    const cj5_int num_slots = cj5__index_num_slots(num_fields);
+    const cj5_int total_size = num_slots * (cj5_int)sizeof(cj5__schema_slot);
+    if (mem == NULL || mem_size < total_size) {
+        return total_size;
+    }
+    CJ5_ASSERT(((uintptr_t)mem & (sizeof(uint32_t) - 1)) == 0);
+
+    cj5__schema_slot* slots = (cj5__schema_slot*)mem;
+    CJ5_MEMSET(slots, 0xff, (size_t)total_size);
+    for (int i = 0; i < num_fields; i++) {
+        uint32_t key_hash = cj5__hash_fnv32(fields[i].key, fields[i].key + cj5__strlen(fields[i].key));
+        cj5_int slot = (cj5_int)(key_hash & (uint32_t)(num_slots - 1));
+        while (slots[slot].field != -1) {
+            slot = (slot + 1) & (num_slots - 1);
+        }
+        slots[slot].key_hash = key_hash;
+        slots[slot].field = i;
+    }
+
+    schema->fields = fields;
+    schema->num_fields = num_fields;
+    schema->mask = (int)(num_slots - 1);
+    schema->slots = slots;
+    return total_size;
+}
+
+static void cj5__bind_defaults(const cj5_schema* schema, uint8_t* obj)
+{
+    for (int i = 0; i < schema->num_fields; i++) {
+        const cj5_field* field = &schema->fields[i];
+        void* member = obj + field->offset;
+        switch (field->type) {
+        case CJ5_FIELD_DOUBLE:
+            *(double*)member = field->def.d;
+            break;
+        case CJ5_FIELD_FLOAT:
+            *(float*)member = (float)field->def.d;
+            break;
+        case CJ5_FIELD_INT:
+            *(int*)member = (int)field->def.i;
+            break;
+        case CJ5_FIELD_UINT:
+            *(uint32_t*)member = (uint32_t)field->def.u;
+            break;
+        case CJ5_FIELD_INT64:
+            *(int64_t*)member = field->def.i;
+            break;
+        case CJ5_FIELD_UINT64:
+            *(uint64_t*)member = field->def.u;
+            break;
+        case CJ5_FIELD_BOOL:
+            *(bool*)member = field->def.b;
+            break;
+        case CJ5_FIELD_STRING:
+            CJ5_ASSERT(field->size > 0);
+            cj5__strcpy((char*)member, field->size, field->def.s ? field->def.s : "",
+                        field->def.s ? cj5__strlen(field->def.s) : 0);
+            break;
+        case CJ5_FIELD_OBJECT:
+            cj5__bind_defaults(field->schema, (uint8_t*)member);
+            break;
+        case CJ5_FIELD_TOKEN:
+            *(cj5_int*)member = -1;
+            break;
+        }
+    }
+}
+
+// writes value `id` to the member of `field`, returns false if the value has a different type
+static bool cj5__bind_field(cj5_result* r, cj5_int id, const cj5_field* field, uint8_t* member)
+{
+    cj5_token_type type = cj5_get_type(r, id);
+    switch (field->type) {
+    case CJ5_FIELD_DOUBLE:
+    case CJ5_FIELD_FLOAT:
+    case CJ5_FIELD_INT:
+    case CJ5_FIELD_UINT:
+    case CJ5_FIELD_INT64:
+    case CJ5_FIELD_UINT64:
+        if (type != CJ5_TOKEN_NUMBER) {
+            return false;
+        }
+        break;
+    case CJ5_FIELD_BOOL:
+        if (type != CJ5_TOKEN_BOOL) {
+            return false;
+        }
+        break;
+    case CJ5_FIELD_STRING:
+        if (type != CJ5_TOKEN_STRING) {
+            return false;
+        }
+        break;
+    case CJ5_FIELD_OBJECT:
+        if (type != CJ5_TOKEN_OBJECT) {
+            return false;
+        }
+        break;
+    case CJ5_FIELD_TOKEN:
+        break;
+    }
+
+    switch (field->type) {
+    case CJ5_FIELD_DOUBLE:
+        *(double*)member = cj5_get_double(r, id);
+        break;
+    case CJ5_FIELD_FLOAT:
+        *(float*)member = cj5_get_float(r, id);
+        break;
+    case CJ5_FIELD_INT:
+        *(int*)member = cj5_get_int(r, id);
+        break;
+    case CJ5_FIELD_UINT:
+        *(uint32_t*)member = cj5_get_uint(r, id);
+        break;
+    case CJ5_FIELD_INT64:
+        *(int64_t*)member = cj5_get_int64(r, id);
+        break;
+    case CJ5_FIELD_UINT64:
+        *(uint64_t*)member = cj5_get_uint64(r, id);
+        break;
+    case CJ5_FIELD_BOOL:
+        *(bool*)member = cj5_get_bool(r, id);
+        break;
+    case CJ5_FIELD_STRING:
+        cj5_get_string(r, id, (char*)member, field->size);
+        break;
+    case CJ5_FIELD_OBJECT:
+        cj5_bind(r, id, field->schema, member);
+        break;
+    case CJ5_FIELD_TOKEN:
+        *(cj5_int*)member = id;
+        break;
+    }
+    return true;
+}
+
+int cj5_bind(cj5_result* r, cj5_int id, const cj5_schema* schema, void* obj)
+{
+    CJ5_ASSERT(id >= 0 && id < r->num_tokens);
+    CJ5_ASSERT(schema->slots);
+
+    cj5__bind_defaults(schema, (uint8_t*)obj);
+    if (cj5_get_type(r, id) != CJ5_TOKEN_OBJECT) {
+        return 0;
+    }
+
+    // fields that have a value already, so duplicate keys don't overwrite the first one
+    uint32_t done[(CJ5_SCHEMA_MAX_FIELDS + 31) / 32];
+    CJ5_MEMSET(done, 0x0, sizeof(uint32_t) * (size_t)((schema->num_fields + 31) / 32));
+
+    const cj5__schema_slot* slots = (const cj5__schema_slot*)schema->slots;
+    int num_found = 0;
+    int num_done = 0;
+    for (cj5_int i = id + 1, end = cj5__next(r, id); i < end && num_done < schema->num_fields;
+         i = cj5__next(r, i)) {
+        if (!cj5__is_key(r, i)) {
+            continue;
+        }
+
+        uint32_t key_hash = cj5__key_hash(r, i);
+        for (int slot = (int)(key_hash & (uint32_t)schema->mask); slots[slot].field != -1;
+             slot = (slot + 1) & schema->mask) {
+            int f = slots[slot].field;
+            if (slots[slot].key_hash != key_hash || (done[f >> 5] & (1u << (f & 31)))) {
+                continue;
+            }
+
+            const cj5_field* field = &schema->fields[f];
+            if (cj5__bind_field(r, i + 1, field, (uint8_t*)obj + field->offset)) {
+                num_found++;
+            }
+            done[f >> 5] |= 1u << (f & 31);
+            num_done++;
+            break;
+        }
+    }
+    return num_found;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Cursor
+// keeps the first error, returns -1 so it can be returned as an invalid position
+static cj5_int cj5__cursor_fail(cj5_cursor* c, cj5_error_code code, cj5_int pos)
+{
+    if (!c->error) {
+        c->error = code;
+        c->error_pos = pos;
+    }
+    return -1;
+}
+
+// returns the end of the comment at `pos`, or `pos` if it's not a comment
+static cj5_int cj5__cursor_comment(const char* json5, cj5_int pos, cj5_int len)
+{
+    if (pos + 1 >= len) {
+        return pos;
+    }
+
+    if (json5[pos + 1] == '/') {
+        return cj5__scan(json5, pos + 2, len, CJ5__SCAN_LINE_END, 0);
+    } else if (json5[pos + 1] == '*') {
+        for (cj5_int i = pos + 2; i < len; i++) {
+            i = cj5__scan(json5, i, len, CJ5__SCAN_CHAR, '*');
+            if (i + 1 < len && json5[i + 1] == '/') {
+                return i + 2;
+            }
+        }
+        return len;
+    }
+    return pos;
+}
+
+// skips whitespace and comments
+static cj5_int cj5__cursor_blank(const char* json5, cj5_int pos, cj5_int len)
+{
+    while (pos < len) {
+        char c = json5[pos];
+        if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+            pos++;
+            continue;
+        }
+
+        cj5_int end = c == '/' ? cj5__cursor_comment(json5, pos, len) : pos;
+        if (end == pos) {
+            break;
+        }
+        pos = end;
+    }
+    return pos;
+}
+
+// checks that a value starts at `pos`
+static cj5_int cj5__cursor_value(cj5_cursor* c, cj5_int pos)
+{
+    if (pos == c->len) {
+        return cj5__cursor_fail(c, CJ5_ERROR_INCOMPLETE, pos);
+    }
+
+    char ch = c->json5[pos];
+    if (ch == ',' || ch == ':' || ch == ']' || ch == '}') {
+        return cj5__cursor_fail(c, CJ5_ERROR_INVALID, pos);
+    }
+    return pos;
+}
+
+// validates the string or primitive at `pos` with the parser, returns the position after it
+static cj5_int cj5__cursor_scalar(cj5_cursor* c, cj5_int pos, cj5_token* token)
+{
+    cj5_parser parser;
+    cj5_parser_init(&parser, token, 1);
+    parser.pos = pos;
+    if (c->json5[pos] == '"' || c->json5[pos] == '\'') {
+        cj5__parse_string(&parser, c->json5, c->len, true);
+    } else {
+        cj5__parse_primitive(&parser, c->json5, c->len, true);
+    }
+
+    if (parser.result.error) {
+        return cj5__cursor_fail(c, parser.result.error, parser.pos);
+    }
+    return parser.pos + 1;
+}
+
+static cj5_int cj5__cursor_skip_string(cj5_cursor* c, cj5_int pos)
+{
+    const char* json5 = c->json5;
+    char str_open = json5[pos];
+    for (cj5_int i = pos + 1; i < c->len; i++) {
+        i = cj5__scan(json5, i, c->len, CJ5__SCAN_STRING, str_open);
+        if (i < c->len && json5[i] == str_open) {
+            return i + 1;
+        }
+        // i is at a backslash, the loop skips the escaped character
+        i++;
+    }
+    return cj5__cursor_fail(c, CJ5_ERROR_INCOMPLETE, pos);
+}
+
+// returns the position after the value at `pos` without validating it, for objects and arrays
+// only the brackets are counted
+static cj5_int cj5__cursor_skip(cj5_cursor* c, cj5_int pos)
+{
+    const char* json5 = c->json5;
+    cj5_int len = c->len;
+    char ch = json5[pos];
+    if (ch == '"' || ch == '\'') {
+        return cj5__cursor_skip_string(c, pos);
+    } else if (ch != '{' && ch != '[') {
+        return cj5__scan(json5, pos, len, CJ5__SCAN_PRIMITIVE, 0);
+    }
+
+    cj5_int depth = 0;
+    for (cj5_int i = pos; i < len; i++) {
+        i = cj5__scan(json5, i, len, CJ5__SCAN_STRUCTURE, 0);
+        if (i == len) {
+            break;
+        }
+
+        switch (json5[i]) {
+        case '{':
+        case '[':
+            depth++;
+            break;
+        case '}':
+        case ']':
+            if (--depth == 0) {
+                return i + 1;
+            }
+            break;
+        case '/': {
+            // a '/' that doesn't start a comment is a part of a primitive
+            cj5_int end = cj5__cursor_comment(json5, i, len);
+            i = end > i ? end - 1 : i;
+            break;
+        }
+        default:
+            i = cj5__cursor_skip_string(c, i) - 1;
+            if (i < 0) {
+                return -1;
+            }
+            break;
+        }
+    }
+    return cj5__cursor_fail(c, CJ5_ERROR_INCOMPLETE, pos);
+}
+
+// reads the key of the object member at `pos`, returns the position of its value
+static cj5_int cj5__cursor_member(cj5_cursor* c, cj5_int pos, cj5_int* key_start, cj5_int* key_end)
+{
+    cj5_token key;
+    cj5_int end = cj5__cursor_scalar(c, pos, &key);
+    if (end < 0) {
+        return -1;
+    } else if (key.type != CJ5_TOKEN_STRING) {
+        return cj5__cursor_fail(c, CJ5_ERROR_INVALID, pos);
+    }
+
+    pos = cj5__cursor_blank(c->json5, end, c->len);
+    if (pos == c->len || c->json5[pos] != ':') {
+        return cj5__cursor_fail(c, pos == c->len ? CJ5_ERROR_INCOMPLETE : CJ5_ERROR_INVALID, pos);
+    }
+
+    *key_start = key.start;
+    *key_end = key.end;
+    return cj5__cursor_value(c, cj5__cursor_blank(c->json5, pos + 1, c->len));
+}
+
+// moves to the member or element at `pos`
+static bool cj5__cursor_move(cj5_cursor* c, cj5_int pos, bool member, int depth)
+{
+    cj5_int key_start = -1;
+    cj5_int key_end = -1;
+    pos = member ? cj5__cursor_member(c, pos, &key_start, &key_end) : cj5__cursor_value(c, pos);
+    if (pos < 0) {
+        return false;
+    }
+
+    c->pos = pos;
+    c->key_start = key_start;
+    c->key_end = key_end;
+    c->depth = depth;
+    return true;
+}
+
+void cj5_cursor_init(cj5_cursor* c, const char* json5, cj5_int len)
+{
+    CJ5_MEMSET(c, 0x0, sizeof(*c));
+    c->json5 = json5;
+    c->len = len;
+    c->key_start = -1;
+    c->key_end = -1;
+    c->pos = cj5__cursor_value(c, cj5__cursor_blank(json5, 0, len));
+}
+
+cj5_token_type cj5_cursor_type(const cj5_cursor* c)
+{
+    if (c->error) {
+        return CJ5_TOKEN_NULL;
+    }
+
+    switch (c->json5[c->pos]) {
+    case '{':   return CJ5_TOKEN_OBJECT;
+    case '[':   return CJ5_TOKEN_ARRAY;
+    case '"':
+    case '\'':  return CJ5_TOKEN_STRING;
+    case 'n':   return CJ5_TOKEN_NULL;
+    case 't':
+    case 'f':   return CJ5_TOKEN_BOOL;
+    default:    return CJ5_TOKEN_NUMBER;
+    }
+}
+
+bool cj5_cursor_enter(cj5_cursor* c)
+{
+    cj5_token_type type = cj5_cursor_type(c);
+    if (c->error || (type != CJ5_TOKEN_OBJECT && type != CJ5_TOKEN_ARRAY)) {
+        return false;
+    }
+
+    cj5_int pos = cj5__cursor_blank(c->json5, c->pos + 1, c->len);
+    if (pos == c->len) {
+        cj5__cursor_fail(c, CJ5_ERROR_INCOMPLETE, pos);
+        return false;
+    } else if (c->json5[pos] == '}' || c->json5[pos] == ']') {
+        return false;
+    }
+    return cj5__cursor_move(c, pos, type == CJ5_TOKEN_OBJECT, c->depth + 1);
+}
+
+bool cj5_cursor_next(cj5_cursor* c)
+{
+    if (c->error || c->depth == 0) {
+        return false;
+    }
+
+    cj5_int pos = cj5__cursor_skip(c, c->pos);
+    if (pos < 0) {
+        return false;
+    }
+
+    pos = cj5__cursor_blank(c->json5, pos, c->len);
+    if (pos == c->len) {
+        cj5__cursor_fail(c, CJ5_ERROR_INCOMPLETE, pos);
+        return false;
+    }
+
+    char ch = c->json5[pos];
+    if (ch == ',') {
+        pos = cj5__cursor_blank(c->json5, pos + 1, c->len);
+        // trailing comma
+        if (pos < c->len && (c->json5[pos] == '}' || c->json5[pos] == ']')) {
+            return false;
+        }
+    } else if (ch == '}' || ch == ']') {
+        return false;
+    } else {
+        cj5__cursor_fail(c, CJ5_ERROR_INVALID, pos);
+        return false;
+    }
+    return cj5__cursor_move(c, pos, c->key_start != -1, c->depth);
+}
+
+bool cj5_cursor_seek_hash(cj5_cursor* c, uint32_t key_hash)
+{
+    if (cj5_cursor_type(c) != CJ5_TOKEN_OBJECT) {
+        return false;
+    }
+
+    cj5_cursor member = *c;
+    if (cj5_cursor_enter(&member)) {
+        do {
+            if (cj5__hash_fnv32(&c->json5[member.key_start], &c->json5[member.key_end]) ==
+                key_hash) {
+                *c = member;
+                return true;
+            }
+        } while (cj5_cursor_next(&member));
+    }
+
+    c->error = member.error;
+    c->error_pos = member.error_pos;
+    return false;
+}
+
+bool cj5_cursor_seek(cj5_cursor* c, const char* key)
+{
+    return cj5_cursor_seek_hash(c, cj5__hash_fnv32(key, key + cj5__strlen(key)));
+}
+
+bool cj5_cursor_elem(cj5_cursor* c, cj5_int index)
+{
+    if (cj5_cursor_type(c) != CJ5_TOKEN_ARRAY || index < 0) {
+        return false;
+    }
+
+    cj5_cursor elem = *c;
+    if (cj5_cursor_enter(&elem)) {
+        while (index > 0 && cj5_cursor_next(&elem)) {
+            index--;
+        }
+        if (index == 0 && !elem.error) {
+            *c = elem;
+            return true;
+        }
+    }
+
+    c->error = elem.error;
+    c->error_pos = elem.error_pos;
+    return false;
+}
+
+cj5_result cj5_cursor_parse(cj5_cursor* c, cj5_token* tokens, cj5_int max_tokens)
+{
+    cj5_result r;
+    CJ5_MEMSET(&r, 0x0, sizeof(r));
+    cj5_token_type type = cj5_cursor_type(c);
+    if (!c->error && (type == CJ5_TOKEN_OBJECT || type == CJ5_TOKEN_ARRAY)) {
+        cj5_int end = cj5__cursor_skip(c, c->pos);
+        if (end >= 0) {
+            return cj5_parse(&c->json5[c->pos], end - c->pos, tokens, max_tokens);
+        }
+    } else if (!c->error) {
+        cj5_token token;
+        if (cj5__cursor_scalar(c, c->pos, &token) >= 0) {
+            r.num_tokens = 1;
+            r.json5 = &c->json5[c->pos];
+            if (max_tokens < 1 || !tokens) {
+                r.error = CJ5_ERROR_OVERFLOW;
+                return r;
+            }
+
+            token.start -= c->pos;
+            token.end -= c->pos;
+            if (token.type == CJ5_TOKEN_STRING) {
+                // unquoted keyname, it's just a string here
+                token.key_hash = 0;
+                token.key_start = token.key_end = 0;
+            }
+            tokens[0] = token;
+            r.tokens = tokens;
+            return r;
+        }
+    }
+
+    r.error = c->error;
+    return r;
+}
+
+// parses the current scalar value into a single token result, if it has `type`
+static bool cj5__cursor_token(cj5_cursor* c, cj5_token_type type, cj5_result* r,
+                              cj5_token* token)
+{
+    if (cj5_cursor_type(c) != type || cj5__cursor_scalar(c, c->pos, token) < 0 ||
+        token->type != type) {
+        return false;
+    }
+
+    CJ5_MEMSET(r, 0x0, sizeof(*r));
+    r->num_tokens = 1;
+    r->tokens = token;
+    r->json5 = c->json5;
+    return true;
+}
+
+double cj5_cursor_get_double(cj5_cursor* c, double def_val)
+{
+    cj5_result r;
+    cj5_token token;
+    return cj5__cursor_token(c, CJ5_TOKEN_NUMBER, &r, &token) ? cj5_get_double(&r, 0) : def_val;
+}
+
+float cj5_cursor_get_float(cj5_cursor* c, float def_val)
+{
+    cj5_result r;
+    cj5_token token;
+    return cj5__cursor_token(c, CJ5_TOKEN_NUMBER, &r, &token) ? cj5_get_float(&r, 0) : def_val;
+}
+
+int cj5_cursor_get_int(cj5_cursor* c, int def_val)
+{
+    cj5_result r;
+    cj5_token token;
+    return cj5__cursor_token(c, CJ5_TOKEN_NUMBER, &r, &token) ? cj5_get_int(&r, 0) : def_val;
+}
+
+uint32_t cj5_cursor_get_uint(cj5_cursor* c, uint32_t def_val)
+{
+    cj5_result r;
+    cj5_token token;
+    return cj5__cursor_token(c, CJ5_TOKEN_NUMBER, &r, &token) ? cj5_get_uint(&r, 0) : def_val;
 }
 
+int64_t cj5_cursor_get_int64(cj5_cursor* c, int64_t def_val)
+{
+    cj5_result r;
+    cj5_token token;
+    return cj5__cursor_token(c, CJ5_TOKEN_NUMBER, &r, &token) ? cj5_get_int64(&r, 0) : def_val;
+}
 
-////////////////////////////////////////////////////////////////////////////////////////////////////
-// Helper functions to work with tokens
-#    if CJ5_TOKEN_HELPERS
-#        include <stdlib.h>
+uint64_t cj5_cursor_get_uint64(cj5_cursor* c, uint64_t def_val)
+{
+    cj5_result r;
+    cj5_token token;
+    return cj5__cursor_token(c, CJ5_TOKEN_NUMBER, &r, &token) ? cj5_get_uint64(&r, 0) : def_val;
+}
 
-static int cj5__seek_recursive(cj5_result* r, int parent_id, uint32_t key_hash)
+bool cj5_cursor_get_bool(cj5_cursor* c, bool def_val)
 {
-    const cj5_token* parent_tok = &r->tokens[parent_id];
+    cj5_result r;
+    cj5_token token;
+    return cj5__cursor_token(c, CJ5_TOKEN_BOOL, &r, &token) ? cj5_get_bool(&r, 0) : def_val;
+}
 
-    for (int i = parent_id + 1, count = 0; i < r->num_tokens && count < parent_tok->size; i++) {
-        const cj5_token* tok = &r->tokens[i];
+const char* cj5_cursor_get_string(cj5_cursor* c, char* str, int max_str, const char* def_val)
+{
+    cj5_result r;
+    cj5_token token;
+    return cj5__cursor_token(c, CJ5_TOKEN_STRING, &r, &token) ? cj5_get_string(&r, 0, str, max_str)
+                                                              : def_val;
+}
 
-        if (tok->size != 1 || tok->type != CJ5_TOKEN_STRING) {
-            continue;
-        }
+#    endif    // CJ5_TOKEN_HELPERS
 
-        if (parent_id == tok->parent_id) {
-            CJ5_ASSERT((i + 1) < r->num_tokens);
-            if (key_hash == tok->key_hash) {
-                return i + 1;    // return next "value" token (array/objects and primitive values)
-            } else if (r->tokens[i + 1].size) {
-                int found_id = cj5__seek_recursive(r, i + 1, key_hash);
-                if (found_id != -1) {
-                    return found_id;
-                }
-            }
-            count++;
-        }
-    }
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Writer
+typedef struct cj5__diyfp {
+    uint64_t f;
+    int e;
+} cj5__diyfp;
+
+typedef struct cj5__cached_power {
+    uint64_t f;
+    int e;
+    int k;
+} cj5__cached_power;
+
+// normalized 64-bit approximations of 10^k, k = [-300, 324] with steps of 8, for Grisu2
+#    define CJ5__GRISU_ALPHA -60
+static const cj5__cached_power CJ5__CACHED_POWERS[] = {
+    { 0xab70fe17c79ac6caULL, -1060, -300 }, { 0xff77b1fcbebcdc4fULL, -1034, -292 },
+    { 0xbe5691ef416bd60cULL, -1007, -284 }, { 0x8dd01fad907ffc3cULL, -980, -276 },
+    { 0xd3515c2831559a83ULL, -954, -268 }, { 0x9d71ac8fada6c9b5ULL, -927, -260 },
+    { 0xea9c227723ee8bcbULL, -901, -252 }, { 0xaecc49914078536dULL, -874, -244 },
+    { 0x823c12795db6ce57ULL, -847, -236 }, { 0xc21094364dfb5637ULL, -821, -228 },
+    { 0x9096ea6f3848984fULL, -794, -220 }, { 0xd77485cb25823ac7ULL, -768, -212 },
+    { 0xa086cfcd97bf97f4ULL, -741, -204 }, { 0xef340a98172aace5ULL, -715, -196 },
+    { 0xb23867fb2a35b28eULL, -688, -188 }, { 0x84c8d4dfd2c63f3bULL, -661, -180 },
+    { 0xc5dd44271ad3cdbaULL, -635, -172 }, { 0x936b9fcebb25c996ULL, -608, -164 },
+    { 0xdbac6c247d62a584ULL, -582, -156 }, { 0xa3ab66580d5fdaf6ULL, -555, -148 },
+    { 0xf3e2f893dec3f126ULL, -529, -140 }, { 0xb5b5ada8aaff80b8ULL, -502, -132 },
+    { 0x87625f056c7c4a8bULL, -475, -124 }, { 0xc9bcff6034c13053ULL, -449, -116 },
+    { 0x964e858c91ba2655ULL, -422, -108 }, { 0xdff9772470297ebdULL, -396, -100 },
+    { 0xa6dfbd9fb8e5b88fULL, -369, -92 }, { 0xf8a95fcf88747d94ULL, -343, -84 },
+    { 0xb94470938fa89bcfULL, -316, -76 }, { 0x8a08f0f8bf0f156bULL, -289, -68 },
+    { 0xcdb02555653131b6ULL, -263, -60 }, { 0x993fe2c6d07b7facULL, -236, -52 },
+    { 0xe45c10c42a2b3b06ULL, -210, -44 }, { 0xaa242499697392d3ULL, -183, -36 },
+    { 0xfd87b5f28300ca0eULL, -157, -28 }, { 0xbce5086492111aebULL, -130, -20 },
+    { 0x8cbccc096f5088ccULL, -103, -12 }, { 0xd1b71758e219652cULL, -77, -4 },
+    { 0x9c40000000000000ULL, -50, 4 }, { 0xe8d4a51000000000ULL, -24, 12 },
+    { 0xad78ebc5ac620000ULL, 3, 20 }, { 0x813f3978f8940984ULL, 30, 28 },
+    { 0xc097ce7bc90715b3ULL, 56, 36 }, { 0x8f7e32ce7bea5c70ULL, 83, 44 },
+    { 0xd5d238a4abe98068ULL, 109, 52 }, { 0x9f4f2726179a2245ULL, 136, 60 },
+    { 0xed63a231d4c4fb27ULL, 162, 68 }, { 0xb0de65388cc8ada8ULL, 189, 76 },
+    { 0x83c7088e1aab65dbULL, 216, 84 }, { 0xc45d1df942711d9aULL, 242, 92 },
+    { 0x924d692ca61be758ULL, 269, 100 }, { 0xda01ee641a708deaULL, 295, 108 },
+    { 0xa26da3999aef774aULL, 322, 116 }, { 0xf209787bb47d6b85ULL, 348, 124 },
+    { 0xb454e4a179dd1877ULL, 375, 132 }, { 0x865b86925b9bc5c2ULL, 402, 140 },
+    { 0xc83553c5c8965d3dULL, 428, 148 }, { 0x952ab45cfa97a0b3ULL, 455, 156 },
+    { 0xde469fbd99a05fe3ULL, 481, 164 }, { 0xa59bc234db398c25ULL, 508, 172 },
+    { 0xf6c69a72a3989f5cULL, 534, 180 }, { 0xb7dcbf5354e9beceULL, 561, 188 },
+    { 0x88fcf317f22241e2ULL, 588, 196 }, { 0xcc20ce9bd35c78a5ULL, 614, 204 },
+    { 0x98165af37b2153dfULL, 641, 212 }, { 0xe2a0b5dc971f303aULL, 667, 220 },
+    { 0xa8d9d1535ce3b396ULL, 694, 228 }, { 0xfb9b7cd9a4a7443cULL, 720, 236 },
+    { 0xbb764c4ca7a44410ULL, 747, 244 }, { 0x8bab8eefb6409c1aULL, 774, 252 },
+    { 0xd01fef10a657842cULL, 800, 260 }, { 0x9b10a4e5e9913129ULL, 827, 268 },
+    { 0xe7109bfba19c0c9dULL, 853, 276 }, { 0xac2820d9623bf429ULL, 880, 284 },
+    { 0x80444b5e7aa7cf85ULL, 907, 292 }, { 0xbf21e44003acdd2dULL, 933, 300 },
+    { 0x8e679c2f5e44ff8fULL, 960, 308 }, { 0xd433179d9c8cb841ULL, 986, 316 },
+    { 0x9e19db92b4e31ba9ULL, 1013, 324 },
+};
+
+static const char CJ5__DIGITS2[] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static inline cj5__diyfp cj5__diyfp_make(uint64_t f, int e)
+{
+    cj5__diyfp r;
+    r.f = f;
+    r.e = e;
+    return r;
+}
 
-    return -1;
+static inline cj5__diyfp cj5__diyfp_mul(cj5__diyfp x, cj5__diyfp y)
+{
+    uint64_t hi;
+    uint64_t lo = cj5__mul128(x.f, y.f, &hi);
+    return cj5__diyfp_make(hi + (lo >> 63), x.e + y.e + 64);
 }
 
-static bool cj5__tofloat(const char* str, double* ofloat)
+static inline void cj5__grisu2_round(char* buf, int len, uint64_t dist, uint64_t delta,
+                                     uint64_t rest, uint64_t ten_k)
 {
-    // skip leading whitespace
-    while (*str && cj5__isspace(*str)) {
-        str++;
+    // move the last digit towards w while it stays in the [M-, M+] range
+    while (rest < dist && delta - rest >= ten_k &&
+           (rest + ten_k < dist || dist - rest > rest + ten_k - dist)) {
+        buf[len - 1]--;
+        rest += ten_k;
     }
-    int sign = 1;
+}
 
-    const char* pC = str;
-    if (*pC == '-') {
-        sign = -1;
-        pC++;
+// generates the shortest digits in [M-, M+] that are closest to w, returns the number of digits
+static int cj5__grisu2_digit_gen(char* buf, int* dec_exp, cj5__diyfp m_minus, cj5__diyfp w,
+                                 cj5__diyfp m_plus)
+{
+    uint64_t delta = m_plus.f - m_minus.f;
+    uint64_t dist = m_plus.f - w.f;
+    int shift = -m_plus.e;
+    uint64_t one = 1ull << shift;
+    uint32_t p1 = (uint32_t)(m_plus.f >> shift);
+    uint64_t p2 = m_plus.f & (one - 1);
+
+    uint32_t pow10 = 1000000000;
+    int n = 10;
+    while (n > 1 && p1 < pow10) {
+        pow10 /= 10;
+        n--;
     }
 
-    // parse integer part
-    int64_t tmp = 0;
-    while (*pC >= '0' && *pC <= '9') {
-        tmp *= 10;
-        tmp += *pC - '0';
-        pC++;
+    // integral part
+    int len = 0;
+    while (n > 0) {
+        buf[len++] = (char)('0' + p1 / pow10);
+        p1 %= pow10;
+        n--;
+        uint64_t rest = ((uint64_t)p1 << shift) + p2;
+        if (rest <= delta) {
+            *dec_exp += n;
+            cj5__grisu2_round(buf, len, dist, delta, rest, (uint64_t)pow10 << shift);
+            return len;
+        }
+        pow10 /= 10;
     }
 
-    if (*pC == 0) {
-        *ofloat = (double)(sign >= 0 ? tmp : -tmp);
-        return true;
+    // fractional part
+    int m = 0;
+    for (;;) {
+        p2 *= 10;
+        buf[len++] = (char)('0' + (p2 >> shift));
+        p2 &= one - 1;
+        m++;
+        delta *= 10;
+        dist *= 10;
+        if (p2 <= delta) {
+            break;
+        }
     }
+    *dec_exp -= m;
+    cj5__grisu2_round(buf, len, dist, delta, p2, one);
+    return len;
+}
 
-    // Parse fraction
-    if (*pC == '.') {
-        pC++;
-
-        int64_t divisor = sign;
-        while (*pC >= '0' && *pC <= '9') {
-            divisor *= 10;
-            tmp *= 10;
-            tmp += *pC - '0';
-            pC++;
-        }
+// Grisu2: shortest digits of a positive double that read back to the same value
+// returns the number of digits, value = digits * 10^dec_exp
+static int cj5__grisu2(char* buf, int* dec_exp, double value)
+{
+    uint64_t bits;
+    CJ5_MEMCPY(&bits, &value, sizeof(bits));
+    uint64_t f = bits & ((1ull << 52) - 1);
+    int e = (int)(bits >> 52) & 0x7FF;
+
+    // boundaries m- and m+ are in the middle of value and its neighbours
+    cj5__diyfp v = e == 0 ? cj5__diyfp_make(f, 1 - 1075) : cj5__diyfp_make(f | (1ull << 52), e - 1075);
+    cj5__diyfp m_plus = cj5__diyfp_make(2 * v.f + 1, v.e - 1);
+    cj5__diyfp m_minus = (f == 0 && e > 1) ? cj5__diyfp_make(4 * v.f - 1, v.e - 2)
+                                            : cj5__diyfp_make(2 * v.f - 1, v.e - 1);
+    int shift = cj5__clz64(m_plus.f);
+    m_plus.f <<= shift;
+    m_plus.e -= shift;
+    m_minus.f <<= m_minus.e - m_plus.e;
+    m_minus.e = m_plus.e;
+    shift = cj5__clz64(v.f);
+    v.f <<= shift;
+    v.e -= shift;
+
+    // cached power c = 10^-k, so that the products have their binary exponent in [alpha, gamma]
+    int x = CJ5__GRISU_ALPHA - m_plus.e - 1;
+    int k = (x * 78913) / (1 << 18) + (x > 0);
+    const cj5__cached_power* cached = &CJ5__CACHED_POWERS[(300 + k + 7) / 8];
+    cj5__diyfp c = cj5__diyfp_make(cached->f, cached->e);
+
+    cj5__diyfp w = cj5__diyfp_mul(v, c);
+    cj5__diyfp w_minus = cj5__diyfp_mul(m_minus, c);
+    cj5__diyfp w_plus = cj5__diyfp_mul(m_plus, c);
+    *dec_exp = -cached->k;
+    return cj5__grisu2_digit_gen(buf, dec_exp, cj5__diyfp_make(w_minus.f + 1, w_minus.e), w,
+                                 cj5__diyfp_make(w_plus.f - 1, w_plus.e));
+}
 
-        // Skip tailing whitespace
-        while (*pC && cj5__isspace(*pC)) {
-            pC++;
+static inline void cj5__move(char* dst, const char* src, int n)
+{
+    if (dst > src) {
+        for (int i = n - 1; i >= 0; i--) {
+            dst[i] = src[i];
         }
-
-        if (*pC == 0) {
-            *ofloat = (double)tmp / (double)divisor;
-            return true;
+    } else {
+        for (int i = 0; i < n; i++) {
+            dst[i] = src[i];
         }
     }
-
-    *ofloat = strtod(str, NULL);
-    return true;
 }
 
-int cj5_seek_recursive(cj5_result* r, int parent_id, const char* key)
+// writes digits of `value` to `str`, returns the number of characters
+static int cj5__u64toa(char* str, uint64_t value)
 {
-    CJ5_ASSERT(parent_id >= 0 && parent_id < r->num_tokens);
-
-    uint32_t key_hash = cj5__hash_fnv32(key, key + cj5__strlen(key));
-    return cj5__seek_recursive(r, parent_id, key_hash);
+    char tmp[20];
+    int i = 20;
+    while (value >= 100) {
+        uint64_t q = value / 100;
+        int r = (int)(value - q * 100);
+        value = q;
+        i -= 2;
+        CJ5_MEMCPY(&tmp[i], &CJ5__DIGITS2[r * 2], 2);
+    }
+    if (value < 10) {
+        tmp[--i] = (char)('0' + value);
+    } else {
+        i -= 2;
+        CJ5_MEMCPY(&tmp[i], &CJ5__DIGITS2[value * 2], 2);
+    }
+    CJ5_MEMCPY(str, &tmp[i], 20 - i);
+    return 20 - i;
 }
 
-int cj5_seek_hash(cj5_result* r, int parent_id, const uint32_t key_hash)
+// formats a double with the shortest representation that reads back the same, `str` needs 32 bytes
+// numbers are written like 1.0, 0.001, 1.5e-7, 1e+21. NaN and infinity are null in JSON
+static int cj5__dtoa(char* str, double value, bool json5)
 {
-    CJ5_ASSERT(parent_id >= 0 && parent_id < r->num_tokens);
-    const cj5_token* parent_tok = &r->tokens[parent_id];
-
-    for (int i = parent_id + 1, count = 0; i < r->num_tokens && count < parent_tok->size; i++) {
-        const cj5_token* tok = &r->tokens[i];
+    uint64_t bits;
+    CJ5_MEMCPY(&bits, &value, sizeof(bits));
+    char* p = str;
+    if (((bits >> 52) & 0x7FF) == 0x7FF) {
+        const char* special = !json5 ? "null"
+                              : (bits & ((1ull << 52) - 1)) ? "NaN"
+                              : (bits >> 63)                ? "-Infinity"
+                                                            : "Infinity";
+        int len = cj5__strlen(special);
+        CJ5_MEMCPY(str, special, len);
+        return len;
+    }
 
-        if (tok->size != 1 || tok->type != CJ5_TOKEN_STRING) {
-            continue;
-        }
+    if (bits >> 63) {
+        *p++ = '-';
+        value = -value;
+    }
+    if (value == 0) {
+        CJ5_MEMCPY(p, "0.0", 3);
+        return (int)(p - str) + 3;
+    }
 
-        if (parent_id == tok->parent_id) {
-            if (key_hash == tok->key_hash) {
-                CJ5_ASSERT((i + 1) < r->num_tokens);
-                return i + 1;    // return next "value" token (array/objects and primitive values)
-            }
-            count++;
-        }
+    int dec_exp;
+    int k = cj5__grisu2(p, &dec_exp, value);
+    int n = k + dec_exp;    // position of the decimal point
+
+    if (k <= n && n <= 15) {
+        // 1234e5 -> 123400000.0
+        CJ5_MEMSET(p + k, '0', n - k);
+        p[n] = '.';
+        p[n + 1] = '0';
+        return (int)(p - str) + n + 2;
+    } else if (0 < n && n <= 15) {
+        // 1234e-2 -> 12.34
+        cj5__move(p + n + 1, p + n, k - n);
+        p[n] = '.';
+        return (int)(p - str) + k + 1;
+    } else if (-4 < n && n <= 0) {
+        // 1234e-6 -> 0.001234
+        cj5__move(p + 2 - n, p, k);
+        p[0] = '0';
+        p[1] = '.';
+        CJ5_MEMSET(p + 2, '0', -n);
+        return (int)(p - str) + 2 - n + k;
     }
 
-    return -1;
+    // 1234e30 -> 1.234e+33
+    if (k > 1) {
+        cj5__move(p + 2, p + 1, k - 1);
+        p[1] = '.';
+        p += k + 1;
+    } else {
+        p += 1;
+    }
+    *p++ = 'e';
+    int e = n - 1;
+    *p++ = e < 0 ? '-' : '+';
+    p += cj5__u64toa(p, (uint64_t)(e < 0 ? -e : e));
+    return (int)(p - str);
 }
 
-int cj5_seek(cj5_result* r, int parent_id, const char* key)
+// `len` stops counting at CJ5__WRITER_MAX_LEN, and the buffer stops growing at
+// CJ5__WRITER_MAX_CAPACITY, so doubling it can't overflow `cj5_int` or the size of an allocation
+#    if CJ5_LARGE
+#        define CJ5__WRITER_MAX_LEN INT64_MAX
+#        define CJ5__WRITER_MAX_CAPACITY (PTRDIFF_MAX / 2)
+#    else
+#        define CJ5__WRITER_MAX_LEN INT32_MAX
+#        define CJ5__WRITER_MAX_CAPACITY (INT32_MAX / 2)
+#    endif
+
+static bool cj5__writer_grow(cj5_writer* w, cj5_int size)
 {
-    CJ5_ASSERT(parent_id >= 0 && parent_id < r->num_tokens);
+    if (!w->realloc_fn) {
+        return false;
+    }
 
-    uint32_t key_hash = cj5__hash_fnv32(key, key + cj5__strlen(key));
+    cj5_int capacity = w->capacity < 128 ? 256 : w->capacity;
+    while (capacity < size) {
+        if (capacity > CJ5__WRITER_MAX_CAPACITY) {
+            return false;
+        }
+        capacity *= 2;
+    }
 
-    return cj5_seek_hash(r, parent_id, key_hash);
+    char* buf = (char*)w->realloc_fn(w->buf, (size_t)capacity, w->realloc_user);
+    if (!buf) {
+        return false;
+    }
+
+    w->buf = buf;
+    w->capacity = capacity;
+    return true;
 }
 
-const char* cj5_get_string(cj5_result* r, int id, char* str, int max_str)
+// returns the memory for the next `n` bytes, or NULL if the buffer is full (but still counts them)
+static inline char* cj5__writer_reserve(cj5_writer* w, cj5_int n)
 {
-    CJ5_ASSERT(id >= 0 && id < r->num_tokens);
-    const cj5_token* tok = &r->tokens[id];
-    CJ5_ASSERT(tok->type == CJ5_TOKEN_STRING);
-    return cj5__strcpy(str, max_str, &r->json5[tok->start], tok->end - tok->start);
+    cj5_int len = w->len;
+    if (n > CJ5__WRITER_MAX_LEN - len) {
+        w->len = CJ5__WRITER_MAX_LEN;
+        w->error = CJ5_ERROR_OVERFLOW;
+        return NULL;
+    }
+    w->len += n;
+    if (w->error == CJ5_ERROR_OVERFLOW) {
+        return NULL;
+    }
+    if (w->len <= w->capacity || cj5__writer_grow(w, w->len)) {
+        return w->buf + len;
+    }
+    w->error = CJ5_ERROR_OVERFLOW;
+    return NULL;
 }
 
-double cj5_get_double(cj5_result* r, int id)
+static inline void cj5__write(cj5_writer* w, const char* str, cj5_int n)
 {
-    CJ5_ASSERT(id >= 0 && id < r->num_tokens);
-    const cj5_token* tok = &r->tokens[id];
-    CJ5_ASSERT(tok->type == CJ5_TOKEN_NUMBER);
-    char snum[32];
-    double num;
-    cj5__strcpy(snum, sizeof(snum), &r->json5[tok->start], tok->end - tok->start);
-    bool valid = cj5__tofloat(snum, &num);
-    CJ5__UNUSED(valid);
-    CJ5_ASSERT(valid);
-    return num;
+    char* p = cj5__writer_reserve(w, n);
+    if (p && n > 0) {
+        CJ5_MEMCPY(p, str, n);
+    }
 }
 
-float cj5_get_float(cj5_result* r, int id)
+static inline void cj5__write_char(cj5_writer* w, char c)
 {
-    return (float)cj5_get_double(r, id);
+    char* p = cj5__writer_reserve(w, 1);
+    if (p) {
+        *p = c;
+    }
 }
 
-int cj5_get_int(cj5_result* r, int id)
+static void cj5__write_newline(cj5_writer* w)
 {
-    CJ5_ASSERT(id >= 0 && id < r->num_tokens);
-    const cj5_token* tok = &r->tokens[id];
-    CJ5_ASSERT(tok->type == CJ5_TOKEN_NUMBER);
-    char snum[32];
-    cj5__strcpy(snum, sizeof(snum), &r->json5[tok->start], tok->end - tok->start);
-    return (int)strtol(snum, NULL, tok->num_type != CJ5_TOKEN_NUMBER_HEX ? 10 : 16);
+    if (w->indent > 0) {
+        int n = 1 + w->depth * w->indent;
+        char* p = cj5__writer_reserve(w, n);
+        if (p) {
+            p[0] = '\n';
+            CJ5_MEMSET(p + 1, ' ', n - 1);
+        }
+    }
 }
 
-uint32_t cj5_get_uint(cj5_result* r, int id)
+// separator and indentation before every key or value
+static void cj5__write_prefix(cj5_writer* w)
 {
-    CJ5_ASSERT(id >= 0 && id < r->num_tokens);
-    const cj5_token* tok = &r->tokens[id];
-    CJ5_ASSERT(tok->type == CJ5_TOKEN_NUMBER);
-    char snum[32];
-    cj5__strcpy(snum, sizeof(snum), &r->json5[tok->start], tok->end - tok->start);
-    return (uint32_t)strtoul(snum, NULL, tok->num_type != CJ5_TOKEN_NUMBER_HEX ? 10 : 16);
+    if (w->after_key) {
+        w->after_key = false;
+        return;
+    }
+    if (!w->first) {
+        cj5__write_char(w, ',');
+    }
+    if (w->depth > 0) {
+        cj5__write_newline(w);
+    }
+    w->first = false;
 }
 
-uint64_t cj5_get_uint64(cj5_result* r, int id)
+static void cj5__write_escaped(cj5_writer* w, const char* str, cj5_int len)
 {
-    CJ5_ASSERT(id >= 0 && id < r->num_tokens);
-    const cj5_token* tok = &r->tokens[id];
-    CJ5_ASSERT(tok->type == CJ5_TOKEN_NUMBER);
-    char snum[64];
-    cj5__strcpy(snum, sizeof(snum), &r->json5[tok->start], tok->end - tok->start);
-    return strtoull(snum, NULL, tok->num_type != CJ5_TOKEN_NUMBER_HEX ? 10 : 16);
+    static const char hex[] = "0123456789abcdef";
+
+    cj5_int pos = 0;
+    while (pos < len) {
+        // copy everything up to the next character that needs escaping in one go
+        cj5_int esc = cj5__scan(str, pos, len, CJ5__SCAN_ESCAPE, 0);
+        cj5__write(w, &str[pos], esc - pos);
+        if (esc == len) {
+            break;
+        }
+
+        char c = str[esc];
+        char seq[6] = { '\\', c, 0, 0, 0, 0 };
+        int n = 2;
+        switch (c) {
+        case '"':
+        case '\\':
+            break;
+        case '\b':  seq[1] = 'b';   break;
+        case '\f':  seq[1] = 'f';   break;
+        case '\n':  seq[1] = 'n';   break;
+        case '\r':  seq[1] = 'r';   break;
+        case '\t':  seq[1] = 't';   break;
+        default:
+            seq[1] = 'u';
+            seq[2] = '0';
+            seq[3] = '0';
+            seq[4] = hex[(uint8_t)c >> 4];
+            seq[5] = hex[c & 0xF];
+            n = 6;
+            break;
+        }
+        cj5__write(w, seq, n);
+        pos = esc + 1;
+    }
 }
 
-int64_t cj5_get_int64(cj5_result* r, int id)
+// writes a quoted string, `unescape` decodes the escape sequences of a string from a json5 document
+static void cj5__write_quoted(cj5_writer* w, const char* str, cj5_int len, bool unescape)
 {
-    CJ5_ASSERT(id >= 0 && id < r->num_tokens);
-    const cj5_token* tok = &r->tokens[id];
-    CJ5_ASSERT(tok->type == CJ5_TOKEN_NUMBER);
-    char snum[64];
-    cj5__strcpy(snum, sizeof(snum), &r->json5[tok->start], tok->end - tok->start);
-    return strtoll(snum, NULL, tok->num_type != CJ5_TOKEN_NUMBER_HEX ? 10 : 16);
+    cj5__write_char(w, '"');
+    if (!unescape) {
+        cj5__write_escaped(w, str, len);
+    } else {
+        cj5_int pos = 0;
+        while (pos < len) {
+            cj5_int esc = cj5__scan(str, pos, len, CJ5__SCAN_CHAR, '\\');
+            cj5__write_escaped(w, &str[pos], esc - pos);
+            if (esc == len) {
+                break;
+            }
+
+            char decoded[4];
+            int num_decoded;
+            pos = cj5__unescape_one(str, esc, len, decoded, &num_decoded);
+            cj5__write_escaped(w, decoded, num_decoded);
+        }
+    }
+    cj5__write_char(w, '"');
 }
 
-bool cj5_get_bool(cj5_result* r, int id)
+// same rules as key names in `cj5__parse_primitive`
+static bool cj5__is_identifier(const char* str, cj5_int len)
 {
-    CJ5_ASSERT(id >= 0 && id < r->num_tokens);
-    const cj5_token* tok = &r->tokens[id];
-    CJ5_ASSERT(tok->type == CJ5_TOKEN_BOOL);
-    CJ5_ASSERT((tok->end - tok->start) >= 4);
-
-    uint32_t fourcc = *((const uint32_t*)&r->json5[tok->start]);
-    if (fourcc == CJ5__TRUE_FOURCC) {
-        return true;
-    } else if (fourcc == CJ5__FALSE_FOURCC) {
-        return false;
-    } else {
-        CJ5_ASSERT(0);
+    if (len == 0 || cj5__isnum(str[0])) {
         return false;
     }
+    for (cj5_int i = 0; i < len; i++) {
+        if (!cj5__islowerchar(str[i]) && !cj5__isupperchar(str[i]) && !cj5__isnum(str[i]) &&
+            str[i] != '_') {
+            return false;
+        }
+    }
+    return true;
 }
 
-double cj5_seekget_double(cj5_result* r, int parent_id, const char* key, double def_val)
+static void cj5__write_key(cj5_writer* w, const char* key, cj5_int len, bool unescape)
 {
-    int id = cj5_seek(r, parent_id, key);
-    return id > -1 ? cj5_get_double(r, id) : def_val;
+    cj5__write_prefix(w);
+    if (w->json5 && !unescape && cj5__is_identifier(key, len)) {
+        cj5__write(w, key, len);
+    } else {
+        cj5__write_quoted(w, key, len, unescape);
+    }
+    if (w->indent > 0) {
+        cj5__write(w, ": ", 2);
+    } else {
+        cj5__write_char(w, ':');
+    }
+    w->after_key = true;
 }
 
-float cj5_seekget_float(cj5_result* r, int parent_id, const char* key, float def_val)
+static void cj5__write_begin(cj5_writer* w, char c)
 {
-    int id = cj5_seek(r, parent_id, key);
-    return id > -1 ? cj5_get_float(r, id) : def_val;
+    cj5__write_prefix(w);
+    cj5__write_char(w, c);
+    w->depth++;
+    w->first = true;
 }
 
-int cj5_seekget_int(cj5_result* r, int parent_id, const char* key, int def_val)
+static void cj5__write_end(cj5_writer* w, char c)
 {
-    int id = cj5_seek(r, parent_id, key);
-    return id > -1 ? cj5_get_int(r, id) : def_val;
+    CJ5_ASSERT(w->depth > 0);
+    w->depth--;
+    if (!w->first) {
+        cj5__write_newline(w);
+    }
+    cj5__write_char(w, c);
+    w->first = false;
 }
 
-uint32_t cj5_seekget_uint(cj5_result* r, int parent_id, const char* key, uint32_t def_val)
+void cj5_writer_init(cj5_writer* w, char* buf, cj5_int capacity)
 {
-    int id = cj5_seek(r, parent_id, key);
-    return id > -1 ? cj5_get_uint(r, id) : def_val;
+    CJ5_MEMSET(w, 0x0, sizeof(*w));
+    w->buf = buf;
+    w->capacity = buf ? capacity : 0;
+    w->first = true;
 }
 
-uint64_t cj5_seekget_uint64(cj5_result* r, int parent_id, const char* key, uint64_t def_val)
+void cj5_writer_set_realloc(cj5_writer* w, cj5_realloc_fn* realloc_fn, void* user)
 {
-    int id = cj5_seek(r, parent_id, key);
-    return id > -1 ? cj5_get_uint64(r, id) : def_val;
+    w->realloc_fn = realloc_fn;
+    w->realloc_user = user;
 }
 
-int64_t cj5_seekget_int64(cj5_result* r, int parent_id, const char* key, int64_t def_val)
+cj5_error_code cj5_writer_finish(cj5_writer* w)
 {
-    int id = cj5_seek(r, parent_id, key);
-    return id > -1 ? cj5_get_int64(r, id) : def_val;
+    cj5__write_char(w, '\0');
+    if (w->error == CJ5_ERROR_NONE) {
+        w->len--;
+    }
+    return w->error;
 }
 
-bool cj5_seekget_bool(cj5_result* r, int parent_id, const char* key, bool def_val)
+void cj5_write_begin_object(cj5_writer* w)
 {
-    int id = cj5_seek(r, parent_id, key);
-    return id > -1 ? cj5_get_bool(r, id) : def_val;
+    cj5__write_begin(w, '{');
 }
 
-const char* cj5_seekget_string(cj5_result* r, int parent_id, const char* key, char* str,
-                               int max_str, const char* def_val)
+void cj5_write_end_object(cj5_writer* w)
 {
-    int id = cj5_seek(r, parent_id, key);
-    return id > -1 ? cj5_get_string(r, id, str, max_str) : def_val;
+    cj5__write_end(w, '}');
 }
 
-int cj5_seekget_array_double(cj5_result* r, int parent_id, const char* key, double* values,
-                             int max_values)
+void cj5_write_begin_array(cj5_writer* w)
 {
-    int id = key != NULL ? cj5_seek(r, parent_id, key) : parent_id;
-    if (id != -1) {
-        const cj5_token* tok = &r->tokens[id];
-        CJ5__UNUSED(tok);
-        CJ5_ASSERT(tok->type == CJ5_TOKEN_ARRAY);
-        int count = 0;
-        for (int i = id + 1, ic = r->num_tokens; i < ic && r->tokens[i].parent_id == id && count < max_values; i++) {
-            values[count++] = cj5_get_double(r, i);
-        }
-        return count;
-    } else {
-        return 0;
-    }
+    cj5__write_begin(w, '[');
 }
 
-int cj5_seekget_array_float(cj5_result* r, int parent_id, const char* key, float* values,
-                            int max_values)
+void cj5_write_end_array(cj5_writer* w)
 {
-    int id = key != NULL ? cj5_seek(r, parent_id, key) : parent_id;
-    if (id != -1) {
-        const cj5_token* tok = &r->tokens[id];
-        CJ5__UNUSED(tok);
-        CJ5_ASSERT(tok->type == CJ5_TOKEN_ARRAY);
-        int count = 0;
-        for (int i = id + 1, ic = r->num_tokens; i < ic && r->tokens[i].parent_id == id && count < max_values; i++) {
-            values[count++] = cj5_get_float(r, i);
-        }
-        return count;
-    } else {
-        return 0;
-    }
+    cj5__write_end(w, ']');
 }
 
-int cj5_seekget_array_int16(cj5_result* r, int parent_id, const char* key, int16_t* values,
-                            int max_values)
+void cj5_write_key(cj5_writer* w, const char* key, cj5_int len)
 {
-    int id = key != NULL ? cj5_seek(r, parent_id, key) : parent_id;
-    if (id != -1) {
-        const cj5_token* tok = &r->tokens[id];
-        CJ5__UNUSED(tok);
-        CJ5_ASSERT(tok->type == CJ5_TOKEN_ARRAY);
-        int count = 0;
-        for (int i = id + 1, ic = r->num_tokens; i < ic && r->tokens[i].parent_id == id && count < max_values; i++) {
-            values[count++] = (int16_t)cj5_get_int(r, i);
-        }
-        return count;
-    } else {
-        return 0;
-    }
+    cj5__write_key(w, key, len < 0 ? cj5__strlen(key) : len, false);
 }
 
-int cj5_seekget_array_uint16(cj5_result* r, int parent_id, const char* key, uint16_t* values,
-                             int max_values)
+void cj5_write_string(cj5_writer* w, const char* str, cj5_int len)
 {
-    int id = key != NULL ? cj5_seek(r, parent_id, key) : parent_id;
-    if (id != -1) {
-        const cj5_token* tok = &r->tokens[id];
-        CJ5__UNUSED(tok);
-        CJ5_ASSERT(tok->type == CJ5_TOKEN_ARRAY);
-        int count = 0;
-        for (int i = id + 1, ic = r->num_tokens; i < ic && r->tokens[i].parent_id == id && count < max_values; i++) {
-            values[count++] = (uint16_t)cj5_get_int(r, i);
-        }
-        return count;
-    } else {
-        return 0;
-    }
+    cj5__write_prefix(w);
+    cj5__write_quoted(w, str, len < 0 ? cj5__strlen(str) : len, false);
 }
 
+void cj5_write_double(cj5_writer* w, double value)
+{
+    char str[32];
+    int len = cj5__dtoa(str, value, w->json5);
+    cj5__write_prefix(w);
+    cj5__write(w, str, len);
+}
 
-int cj5_seekget_array_int(cj5_result* r, int parent_id, const char* key, int* values,
-                          int max_values)
+void cj5_write_int64(cj5_writer* w, int64_t value)
 {
-    int id = key != NULL ? cj5_seek(r, parent_id, key) : parent_id;
-    if (id != -1) {
-        const cj5_token* tok = &r->tokens[id];
-        CJ5__UNUSED(tok);
-        CJ5_ASSERT(tok->type == CJ5_TOKEN_ARRAY);
-        int count = 0;
-        for (int i = id + 1, ic = r->num_tokens; i < ic && r->tokens[i].parent_id == id && count < max_values; i++) {
-            values[count++] = cj5_get_int(r, i);
-        }
-        return count;
-    } else {
-        return 0;
+    char str[21];
+    int len = 0;
+    uint64_t mag = (uint64_t)value;
+    if (value < 0) {
+        str[len++] = '-';
+        mag = 0 - mag;
     }
+    len += cj5__u64toa(&str[len], mag);
+    cj5__write_prefix(w);
+    cj5__write(w, str, len);
 }
 
-int cj5_seekget_array_uint(cj5_result* r, int parent_id, const char* key, uint32_t* values,
-                           int max_values)
+void cj5_write_uint64(cj5_writer* w, uint64_t value)
 {
-    int id = key != NULL ? cj5_seek(r, parent_id, key) : parent_id;
-    if (id != -1) {
-        const cj5_token* tok = &r->tokens[id];
-        CJ5__UNUSED(tok);
-        CJ5_ASSERT(tok->type == CJ5_TOKEN_ARRAY);
-        int count = 0;
-        for (int i = id + 1, ic = r->num_tokens; i < ic && r->tokens[i].parent_id == id && count < max_values; i++) {
-            values[count++] = cj5_get_uint(r, i);
-        }
-        return count;
-    } else {
-        return 0;
-    }
+    char str[20];
+    int len = cj5__u64toa(str, value);
+    cj5__write_prefix(w);
+    cj5__write(w, str, len);
 }
 
-int cj5_seekget_array_uint64(cj5_result* r, int parent_id, const char* key, uint64_t* values,
-                             int max_values)
+void cj5_write_bool(cj5_writer* w, bool value)
 {
-    int id = key != NULL ? cj5_seek(r, parent_id, key) : parent_id;
-    if (id != -1) {
-        const cj5_token* tok = &r->tokens[id];
-        CJ5__UNUSED(tok);
-        CJ5_ASSERT(tok->type == CJ5_TOKEN_ARRAY);
-        int count = 0;
-        for (int i = id + 1, ic = r->num_tokens; i < ic && r->tokens[i].parent_id == id && count < max_values; i++) {
-            values[count++] = cj5_get_uint64(r, i);
-        }
-        return count;
+    cj5__write_prefix(w);
+    if (value) {
+        cj5__write(w, "true", 4);
     } else {
-        return 0;
+        cj5__write(w, "false", 5);
     }
 }
 
-int cj5_seekget_array_int64(cj5_result* r, int parent_id, const char* key, int64_t* values,
-                            int max_values)
+void cj5_write_null(cj5_writer* w)
 {
-    int id = key != NULL ? cj5_seek(r, parent_id, key) : parent_id;
-    if (id != -1) {
-        const cj5_token* tok = &r->tokens[id];
-        CJ5__UNUSED(tok);
-        CJ5_ASSERT(tok->type == CJ5_TOKEN_ARRAY);
-        int count = 0;
-        for (int i = id + 1, ic = r->num_tokens; i < ic && r->tokens[i].parent_id == id && count < max_values; i++) {
-            values[count++] = cj5_get_int64(r, i);
-        }
-        return count;
-    } else {
-        return 0;
-    }
+    cj5__write_prefix(w);
+    cj5__write(w, "null", 4);
 }
 
-int cj5_seekget_array_bool(cj5_result* r, int parent_id, const char* key, bool* values,
-                           int max_values)
+#    if CJ5_TOKEN_HELPERS
+// numbers like +1, .5, 5. and 007 are only valid in JSON5
+static bool cj5__is_json_number(const char* str, const char* end)
 {
-    int id = key != NULL ? cj5_seek(r, parent_id, key) : parent_id;
-    if (id != -1) {
-        const cj5_token* tok = &r->tokens[id];
-        CJ5__UNUSED(tok);
-        CJ5_ASSERT(tok->type == CJ5_TOKEN_ARRAY);
-        int count = 0;
-        for (int i = id + 1, ic = r->num_tokens; i < ic && r->tokens[i].parent_id == id && count < max_values; i++) {
-            values[count++] = cj5_get_bool(r, i);
+    const char* p = str;
+    if (p < end && *p == '-') {
+        p++;
+    }
+    if (p == end || !cj5__isnum(*p) || (*p == '0' && p + 1 < end && cj5__isnum(p[1]))) {
+        return false;
+    }
+    while (p < end && cj5__isnum(*p)) {
+        p++;
+    }
+    if (p < end && *p == '.') {
+        if (++p == end || !cj5__isnum(*p)) {
+            return false;
+        }
+        while (p < end && cj5__isnum(*p)) {
+            p++;
+        }
+    }
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        if (++p < end && (*p == '+' || *p == '-')) {
+            p++;
+        }
+        if (p == end || !cj5__isnum(*p)) {
+            return false;
+        }
+        while (p < end && cj5__isnum(*p)) {
+            p++;
         }
-        return count;
-    } else {
-        return 0;
     }
+    return p == end;
 }
 
-int cj5_seekget_array_string(cj5_result* r, int parent_id, const char* key, char** strs,
-                             int max_str, int max_values)
+static void cj5__write_number_token(cj5_writer* w, cj5_result* r, const cj5__tok* tok)
 {
-    int id = key != NULL ? cj5_seek(r, parent_id, key) : parent_id;
-    if (id != -1) {
-        const cj5_token* tok = &r->tokens[id];
-        CJ5__UNUSED(tok);
-        CJ5_ASSERT(tok->type == CJ5_TOKEN_ARRAY);
-        int count = 0;
-        for (int i = id + 1, ic = r->num_tokens; i < ic && r->tokens[i].parent_id == id && count < max_values; i++) {
-            cj5_get_string(r, i, strs[count++], max_str);
+    const char* str = &r->json5[tok->start];
+    const char* end = &r->json5[tok->end];
+    if (tok->num_type == CJ5_TOKEN_NUMBER_HEX) {
+        if (w->json5) {
+            cj5__write_prefix(w);
+            cj5__write(w, "0x", 2);
+            cj5__write(w, str, (cj5_int)(end - str));
+        } else {
+            cj5_write_uint64(w, cj5__hextou64(str, end));
         }
-        return count;
+    } else if (cj5__is_json_number(str, end)) {
+        cj5__write_prefix(w);
+        cj5__write(w, str, (cj5_int)(end - str));
     } else {
-        return 0;
-    }
-}
+        bool negative = false, overflow = true;
+        uint64_t value = 0;
+        if (tok->num_type == CJ5_TOKEN_NUMBER_INT) {
+            value = cj5__get_integer(r->json5, tok, &negative, &overflow, NULL);
+        }
 
-int cj5_get_array_elem(cj5_result* r, int id, int index)
-{
-    const cj5_token* tok = &r->tokens[id];
-    CJ5_ASSERT(tok->type == CJ5_TOKEN_ARRAY);
-    CJ5_ASSERT(index < tok->size);
-    for (int i = id + 1, count = 0, ic = r->num_tokens; i < ic && count < tok->size; i++) {
-        if (r->tokens[i].parent_id == id) {
-            if (count == index) {
-                return i;
-            }
-            count++;
+        if (overflow || (negative && value > (uint64_t)INT64_MAX + 1)) {
+            cj5_write_double(w, cj5__todouble(str, end));
+        } else if (negative) {
+            cj5_write_int64(w, (int64_t)(0 - value));
+        } else {
+            cj5_write_uint64(w, value);
         }
     }
-    return -1;
 }
 
-int cj5_get_array_elem_incremental(cj5_result* r, int id, int index, int prev_elem)
+void cj5_write_token(cj5_writer* w, cj5_result* r, cj5_int id)
 {
-    const cj5_token* tok = &r->tokens[id];
-    CJ5_ASSERT(tok->type == CJ5_TOKEN_ARRAY);
-    CJ5_ASSERT(index < tok->size);
-    int start = prev_elem <= 0 ? (id + 1) : (prev_elem + 1);
-    for (int i = start, count = index, ic = r->num_tokens; i < ic && count < tok->size; i++) {
-        if (r->tokens[i].parent_id == id) {
-            if (count == index) {
-                return i;
-            }
-            count++;
+    cj5__tok tok = cj5__get_tok(r, id);
+
+    switch (tok.type) {
+    case CJ5_TOKEN_OBJECT:
+    case CJ5_TOKEN_ARRAY:
+        cj5__write_begin(w, tok.type == CJ5_TOKEN_OBJECT ? '{' : '[');
+        for (cj5_int i = id + 1; i < tok.next_id; i = cj5__next(r, i)) {
+            cj5_write_token(w, r, i);
         }
+        cj5__write_end(w, tok.type == CJ5_TOKEN_OBJECT ? '}' : ']');
+        break;
+    case CJ5_TOKEN_STRING:
+        if (tok.key) {
+            // key, the value is the next token
+            cj5__write_key(w, &r->json5[tok.start], tok.end - tok.start, tok.escaped);
+            cj5_write_token(w, r, id + 1);
+        } else {
+            cj5__write_prefix(w);
+            cj5__write_quoted(w, &r->json5[tok.start], tok.end - tok.start, tok.escaped);
+        }
+        break;
+    case CJ5_TOKEN_NUMBER:
+        cj5__write_number_token(w, r, &tok);
+        break;
+    case CJ5_TOKEN_BOOL:
+        cj5_write_bool(w, r->json5[tok.start] == 't');
+        break;
+    case CJ5_TOKEN_NULL:
+        cj5_write_null(w);
+        break;
     }
-    return -1;
 }
-
 #    endif    // CJ5_TOKEN_HELPERS
 #endif        // CJ5_IMPLEMENT
@@ -0,0 +1,259 @@
+// cj5.hpp: C++17 wrapper for cj5.h, header-only, no allocations and no virtual calls
+//          the values are (result, token id) pairs over `cj5_result`, so they are cheap to copy
+//          and work on both token layouts (see `cj5_compact`)
+//
+// Usage:
+//  Include cj5.h with CJ5_IMPLEMENT in one translation unit as usual, and cj5.hpp where needed:
+//
+//        using namespace cj5::literals;
+//        cj5_result r = cj5_parse(json, len, tokens, max_tokens);
+//        cj5::value root = cj5::root(r);
+//        int width = root["window"_key]["width"_key].as_int(640);    // keys hashed at compile time
+//        for (auto [key, val] : root["plugins"_key].members()) {
+//            std::string_view name = key.as_string_view();
+//        }
+//        for (cj5::value v : root["sizes"_key].elements()) {
+//            float s = v.as_float();
+//        }
+//
+// MIT License, see cj5.h
+#pragma once
+
+#include "cj5.h"
+
+#include <cstddef>        // size_t
+#include <cstdint>        // uint32_t, int64_t, etc.
+#include <iterator>       // std::forward_iterator_tag
+#include <string_view>    // std::string_view
+
+namespace cj5 {
+
+// same FNV-1a hash as `cj5_token.key_hash`, so it can be used with `cj5_seek_hash`
+constexpr uint32_t hash(std::string_view str)
+{
+    uint32_t h = 0x811c9dc5;
+    for (char c : str) {
+        h ^= static_cast<uint32_t>(c);
+        h *= 0x01000193;
+    }
+    return h;
+}
+
+// pre-hashed object key, use `"name"_key` to hash it at compile time
+struct key {
+    uint32_t hash;
+
+    constexpr explicit key(uint32_t key_hash) : hash(key_hash) {}
+    constexpr key(const char* str) : hash(cj5::hash(str)) {}
+    constexpr key(std::string_view str) : hash(cj5::hash(str)) {}
+};
+
+namespace literals {
+constexpr key operator""_key(const char* str, std::size_t len)
+{
+    return key(hash(std::string_view(str, len)));
+}
+}    // namespace literals
+
+namespace detail {
+// inlined versions of `cj5_get_type` and `cj5_get_next`, these are in every loop
+inline cj5_token_type type(const cj5_result* r, cj5_int id)
+{
+    return r->compact ? CJ5_COMPACT_TYPE(&r->compact[id]) : r->tokens[id].type;
+}
+
+inline cj5_int next(const cj5_result* r, cj5_int id)
+{
+    return r->compact ? CJ5_COMPACT_NEXT_ID(&r->compact[id], id) : r->tokens[id].next_id;
+}
+
+inline cj5_int start(const cj5_result* r, cj5_int id)
+{
+    return r->compact ? static_cast<cj5_int>(r->compact[id].start) : r->tokens[id].start;
+}
+}    // namespace detail
+
+class value;
+struct member;
+
+// forward iterator over the children of an object or array, jumps over the subtree of each child
+template <typename T>
+class child_iterator {
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = T;
+
+    child_iterator() = default;
+    child_iterator(cj5_result* r, cj5_int id) : r_(r), id_(id) {}
+
+    T operator*() const;
+    child_iterator& operator++()
+    {
+        id_ = detail::next(r_, id_);
+        return *this;
+    }
+    child_iterator operator++(int)
+    {
+        child_iterator it = *this;
+        ++(*this);
+        return it;
+    }
+    bool operator==(const child_iterator& other) const { return id_ == other.id_; }
+    bool operator!=(const child_iterator& other) const { return id_ != other.id_; }
+
+private:
+    cj5_result* r_ = nullptr;
+    cj5_int id_ = 0;
+};
+
+template <typename T>
+class child_range {
+public:
+    child_range(cj5_result* r, cj5_int first, cj5_int last) : begin_(r, first), end_(r, last) {}
+    child_iterator<T> begin() const { return begin_; }
+    child_iterator<T> end() const { return end_; }
+    bool empty() const { return begin_ == end_; }
+
+private:
+    child_iterator<T> begin_;
+    child_iterator<T> end_;
+};
+
+// a token of a parsed document. missing values (failed lookups) are invalid, and all the getters
+// return the default value for them, so lookups can be chained without checks
+class value {
+public:
+    value() = default;
+    value(cj5_result* r, cj5_int id) : r_(r), id_(id) {}
+
+    bool valid() const { return r_ && id_ >= 0; }
+    explicit operator bool() const { return valid(); }
+    cj5_int id() const { return id_; }
+    cj5_result* result() const { return r_; }
+    // CJ5_TOKEN_NULL for missing values, use `valid` or `is_null` to tell them apart
+    cj5_token_type type() const { return valid() ? detail::type(r_, id_) : CJ5_TOKEN_NULL; }
+
+    bool is_object() const { return valid() && type() == CJ5_TOKEN_OBJECT; }
+    bool is_array() const { return valid() && type() == CJ5_TOKEN_ARRAY; }
+    bool is_number() const { return valid() && type() == CJ5_TOKEN_NUMBER; }
+    bool is_string() const { return valid() && type() == CJ5_TOKEN_STRING; }
+    bool is_bool() const { return valid() && type() == CJ5_TOKEN_BOOL; }
+    bool is_null() const { return valid() && type() == CJ5_TOKEN_NULL; }
+
+    // object member, uses the index if there is one (see `cj5_build_index`)
+    value operator[](key k) const
+    {
+        return value(r_, is_object() ? cj5_seek_hash(r_, id_, k.hash) : -1);
+    }
+    // array element, this walks the elements, iterate with `elements` instead to visit all of them
+    value operator[](cj5_int index) const
+    {
+        return value(r_, is_array() ? cj5_get_array_elem(r_, id_, index) : -1);
+    }
+    value query(const cj5_path& path) const
+    {
+        return value(r_, valid() ? cj5_query(r_, id_, &path) : -1);
+    }
+
+    // number of members or elements
+    cj5_int size() const
+    {
+        if (!is_object() && !is_array()) {
+            return 0;
+        } else if (!r_->compact) {
+            return r_->tokens[id_].size;
+        }
+        cj5_int count = 0;
+        for (cj5_int i = id_ + 1, end = detail::next(r_, id_); i < end; i = detail::next(r_, i)) {
+            count++;
+        }
+        return count;
+    }
+
+    // object members as {key, value} pairs, empty for other types
+    child_range<member> members() const
+    {
+        return is_object() ? child_range<member>(r_, id_ + 1, detail::next(r_, id_))
+                           : child_range<member>(r_, 0, 0);
+    }
+    child_range<value> elements() const
+    {
+        return is_array() ? child_range<value>(r_, id_ + 1, detail::next(r_, id_))
+                          : child_range<value>(r_, 0, 0);
+    }
+
+    // string in the source document, escape sequences are not decoded (see `escaped`)
+    std::string_view as_string_view(std::string_view def_val = {}) const
+    {
+        if (!is_string()) {
+            return def_val;
+        }
+        cj5_int len;
+        cj5_get_string_view(r_, id_, &len);
+        return std::string_view(&r_->json5[detail::start(r_, id_)], static_cast<std::size_t>(len));
+    }
+    // decoded string, copied to `str`
+    const char* as_string(char* str, int max_str, const char* def_val = "") const
+    {
+        return is_string() ? cj5_get_string(r_, id_, str, max_str) : def_val;
+    }
+    bool escaped() const { return is_string() && cj5_get_token(r_, id_).escaped; }
+
+    double as_double(double def_val = 0) const
+    {
+        return is_number() ? cj5_get_double(r_, id_) : def_val;
+    }
+    float as_float(float def_val = 0) const
+    {
+        return is_number() ? cj5_get_float(r_, id_) : def_val;
+    }
+    int as_int(int def_val = 0) const { return is_number() ? cj5_get_int(r_, id_) : def_val; }
+    uint32_t as_uint(uint32_t def_val = 0) const
+    {
+        return is_number() ? cj5_get_uint(r_, id_) : def_val;
+    }
+    int64_t as_int64(int64_t def_val = 0) const
+    {
+        return is_number() ? cj5_get_int64(r_, id_) : def_val;
+    }
+    uint64_t as_uint64(uint64_t def_val = 0) const
+    {
+        return is_number() ? cj5_get_uint64(r_, id_) : def_val;
+    }
+    bool as_bool(bool def_val = false) const
+    {
+        return is_bool() ? cj5_get_bool(r_, id_) : def_val;
+    }
+
+private:
+    cj5_result* r_ = nullptr;
+    cj5_int id_ = -1;
+};
+
+struct member {
+    value key;    // string token, the name of the member
+    value val;
+};
+
+template <>
+inline value child_iterator<value>::operator*() const
+{
+    return value(r_, id_);
+}
+
+template <>
+inline member child_iterator<member>::operator*() const
+{
+    return member{ value(r_, id_), value(r_, id_ + 1) };
+}
+
+// the root value of a parsed document, invalid if there was an error
+inline value root(cj5_result& r)
+{
+    return value(&r, r.error == CJ5_ERROR_NONE && r.num_tokens > 0 ? 0 : -1);
+}
+
+}    // namespace cj5
@@ -0,0 +1,508 @@
+// parse, validation and token counting throughput and seek/get latency on a generated corpus,
+// shaped like the usual JSON benchmark files (twitter.json, canada.json, citm_catalog.json) plus
+// deeply nested and comment-heavy JSON5. files given on the command line are measured too.
+// build: cc -O2 bench.c -o bench -lm, or `make bench` in the repo root
+//        with jsmn side by side (JSON files only): `make bench_jsmn JSMN_DIR=<jsmn dir>`, or
+//        cc -O2 -DBENCH_JSMN -I<jsmn dir> bench.c -o bench -lm
+//        with parse statistics (slower): cc -O2 -DCJ5_STATS=1 bench.c -o bench -lm
+// usage: bench [--json] [--size MB] [files...]
+//        --json prints one JSON object per line (corpus, parser and results) for tracking trends
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define CJ5_IMPLEMENT
+#include "../cj5.h"
+
+#if BENCH_JSMN
+#    include "jsmn.h"
+#endif
+
+#define MIN_SECONDS 0.5    // each parser runs at least this long, the fastest run is reported
+#define NUM_SAMPLES 4096   // keys that are looked up in the seek/get test
+
+typedef struct buffer {
+    char* data;
+    int len;
+    int cap;
+} buffer;
+
+typedef struct corpus {
+    const char* name;
+    char* data;
+    int len;
+    int json5;    // has comments or other JSON5 syntax, jsmn can't parse it
+} corpus;
+
+typedef struct sample {
+    cj5_int parent_id;
+    const char* key;
+} sample;
+
+static uint64_t g_rng = 0x9e3779b97f4a7c15ull;
+static int g_json_output = 0;
+
+static unsigned rnd(unsigned n)
+{
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 7;
+    g_rng ^= g_rng << 17;
+    return (unsigned)(g_rng % n);
+}
+
+static void put(buffer* b, const char* fmt, ...)
+{
+    va_list args;
+    for (;;) {
+        va_start(args, fmt);
+        int n = vsnprintf(b->data + b->len, (size_t)(b->cap - b->len), fmt, args);
+        va_end(args);
+        if (n >= 0 && b->len + n < b->cap) {
+            b->len += n;
+            return;
+        }
+        b->cap = b->cap * 2 + n + 1024;
+        b->data = (char*)realloc(b->data, (size_t)b->cap);
+    }
+}
+
+static const char* g_words[] = { "lorem", "ipsum", "dolor", "sit", "amet", "consectetur",
+                                 "adipiscing", "elit", "sed", "do", "eiusmod", "tempor" };
+
+static const char* word(void)
+{
+    return g_words[rnd(sizeof(g_words) / sizeof(g_words[0]))];
+}
+
+// search results with nested users and entities, string heavy with some escapes
+static void gen_twitter(buffer* b, int size)
+{
+    put(b, "{\"statuses\":[");
+    for (int i = 0; b->len < size; i++) {
+        put(b, "%s{\"metadata\":{\"result_type\":\"recent\",\"iso_language_code\":\"%s\"},",
+            i ? "," : "", rnd(2) ? "ja" : "en");
+        put(b, "\"created_at\":\"Sun Aug 31 00:%02d:%02d +0000 2014\",\"id\":5058749240%08u,",
+            rnd(60), rnd(60), rnd(100000000));
+        put(b, "\"id_str\":\"5058749240%08u\",\"text\":\"@%s %s \\u540d\\u524d %s\\n%s %s\",",
+            rnd(100000000), word(), word(), word(), word(), word());
+        put(b, "\"source\":\"<a href=\\\"http://twitter.com/download/iphone\\\" "
+               "rel=\\\"nofollow\\\">Twitter for iPhone</a>\",\"truncated\":false,"
+               "\"in_reply_to_status_id\":null,");
+        put(b, "\"user\":{\"id\":%u,\"name\":\"%s %s\",\"screen_name\":\"%s%u\",\"location\":\"\",",
+            rnd(2000000000), word(), word(), word(), rnd(1000));
+        put(b, "\"description\":\"%s %s %s %s\",\"url\":null,\"followers_count\":%u,", word(),
+            word(), word(), word(), rnd(100000));
+        put(b, "\"friends_count\":%u,\"verified\":%s,\"profile_background_color\":\"C0DEED\"},",
+            rnd(5000), rnd(10) ? "false" : "true");
+        put(b, "\"geo\":null,\"coordinates\":null,\"retweet_count\":%u,\"favorite_count\":%u,",
+            rnd(1000), rnd(1000));
+        put(b, "\"entities\":{\"hashtags\":[],\"symbols\":[],\"urls\":[],\"user_mentions\":[");
+        put(b, "{\"screen_name\":\"%s\",\"name\":\"%s\",\"id\":%u,\"indices\":[0,%u]}]},", word(),
+            word(), rnd(1000000000), rnd(20));
+        put(b, "\"favorited\":false,\"retweeted\":false,\"lang\":\"ja\"}");
+    }
+    put(b, "],\"search_metadata\":{\"completed_in\":0.087,\"max_id\":505874924095815681,"
+           "\"count\":100}}");
+}
+
+// polygons of a GeoJSON feature collection, almost all floats
+static void gen_canada(buffer* b, int size)
+{
+    put(b, "{\"type\":\"FeatureCollection\",\"features\":[{\"type\":\"Feature\","
+           "\"properties\":{\"name\":\"Canada\"},"
+           "\"geometry\":{\"type\":\"Polygon\",\"coordinates\":[");
+    for (int ring = 0; b->len < size; ring++) {
+        put(b, "%s[", ring ? "," : "");
+        double x = -65.613616999999977;
+        double y = 43.420273000000009;
+        for (int i = 0; i < 1000; i++) {
+            x += (double)rnd(2000) / 1e5 - 0.01;
+            y += (double)rnd(2000) / 1e5 - 0.01;
+            put(b, "%s[%.15f,%.15f]", i ? "," : "", x, y);
+        }
+        put(b, "]");
+    }
+    put(b, "]}}]}");
+}
+
+// objects with many numeric keys, integer ids and nulls
+static void gen_citm(buffer* b, int size)
+{
+    put(b, "{\"areaNames\":{");
+    for (int i = 0; i < 200; i++) {
+        put(b, "%s\"2057059%02d\":\"Arri\\u00e8re-sc\\u00e8ne %s\"", i ? "," : "", i, word());
+    }
+    put(b, "},\"events\":{");
+    for (int i = 0; b->len < size / 2; i++) {
+        unsigned id = 138586341 + (unsigned)i;
+        put(b, "%s\"%u\":{\"description\":null,\"id\":%u,\"logo\":null,\"name\":\"%s %s\","
+               "\"subTopicIds\":[337184269,337184283],\"subjectCode\":null,\"subtitle\":null,"
+               "\"topicIds\":[324846099,107888604]}",
+            i ? "," : "", id, id, word(), word());
+    }
+    put(b, "},\"performances\":[");
+    for (int i = 0; b->len < size; i++) {
+        put(b, "%s{\"eventId\":%u,\"id\":%u,\"logo\":null,\"name\":null,\"prices\":[", i ? "," : "",
+            138586341 + rnd(1000), 339887544 + (unsigned)i);
+        for (int p = 0; p < 3; p++) {
+            put(b, "%s{\"amount\":%u,\"audienceSubCategoryId\":337100890,\"seatCategoryId\":%u}",
+                p ? "," : "", 10000 + rnd(90000), 338937295 + (unsigned)p);
+        }
+        put(b, "],\"seatCategories\":[{\"areas\":[{\"areaId\":205705999,\"blockIds\":[]}],"
+               "\"seatCategoryId\":338937295}],\"seatMapImage\":null,\"start\":13727016%05u,"
+               "\"venueCode\":\"PLEYEL_PLEYEL\"}",
+            rnd(100000));
+    }
+    put(b, "]}");
+}
+
+// objects and arrays nested a few hundred levels deep
+static void gen_nested(buffer* b, int size)
+{
+    put(b, "[");
+    for (int i = 0; b->len < size; i++) {
+        int depth = 100 + (int)rnd(400);
+        put(b, "%s", i ? "," : "");
+        for (int d = 0; d < depth; d++) {
+            put(b, (d & 1) ? "[%d," : "{\"k%d\":", d);
+        }
+        put(b, "true");
+        for (int d = depth - 1; d >= 0; d--) {
+            put(b, (d & 1) ? "]" : "}");
+        }
+    }
+    put(b, "]");
+}
+
+// config style JSON5: comments, unquoted keys, single quotes, hex, trailing commas
+static void gen_json5(buffer* b, int size)
+{
+    put(b, "[\n");
+    for (int i = 0; b->len < size; i++) {
+        put(b, "// asset %d\n{\n", i);
+        put(b, "  // identity\n  name: 'asset_%03d', path: \"data/%s/%s.bin\",\n", i, word(),
+            word());
+        put(b, "  /* block comment about the\n     size of this asset */\n");
+        put(b, "  size: 0x%X, scale: +%d.5, offset: .%d, ratio: %d.e3,\n", rnd(100000), rnd(9),
+            rnd(99), rnd(9));
+        put(b, "  tags: ['%s', \"%s\", '%s',],\n", word(), word(), word());
+        put(b, "  render: { enabled: %s, limit: null, layer: %u, },\n", rnd(2) ? "true" : "false",
+            rnd(32));
+        put(b, "},\n");
+    }
+    put(b, "]\n");
+}
+
+static double now(void)
+{
+    return (double)clock() / CLOCKS_PER_SEC;
+}
+
+static void report(const corpus* c, const char* parser, cj5_int num_tokens, double seconds,
+                   double seek_ns, double seek_index_ns)
+{
+    double gbps = (double)c->len / seconds / 1e9;
+    double mtps = (double)num_tokens / seconds / 1e6;
+    if (g_json_output) {
+        printf("{\"corpus\":\"%s\",\"parser\":\"%s\",\"bytes\":%d,\"tokens\":%d,\"seconds\":%.6f,"
+               "\"gb_per_s\":%.4f,\"mtokens_per_s\":%.3f",
+               c->name, parser, c->len, (int)num_tokens, seconds, gbps, mtps);
+        if (seek_ns > 0) {
+            printf(",\"seek_get_ns\":%.2f,\"seek_get_index_ns\":%.2f", seek_ns, seek_index_ns);
+        }
+        printf("}\n");
+    } else {
+        printf("%-16s %-8s %9.2f MB %10d %8.3f GB/s %8.2f Mtok/s", c->name, parser,
+               (double)c->len / (1024 * 1024), (int)num_tokens, gbps, mtps);
+        if (seek_ns > 0) {
+            printf(" %8.1f ns %8.1f ns", seek_ns, seek_index_ns);
+        }
+        printf("\n");
+    }
+}
+
+#if CJ5_STATS
+static void report_stats(const corpus* c, const cj5_stats* s)
+{
+    if (g_json_output) {
+        printf("{\"corpus\":\"%s\",\"stats\":{\"bytes_whitespace\":%d,\"bytes_comments\":%d,"
+               "\"bytes_strings\":%d,\"bytes_numbers\":%d,\"bytes_literals\":%d,\"max_depth\":%d,"
+               "\"max_close_walk\":%d}}\n",
+               c->name, (int)s->bytes_whitespace, (int)s->bytes_comments, (int)s->bytes_strings,
+               (int)s->bytes_numbers, (int)s->bytes_literals, (int)s->max_depth,
+               (int)s->max_close_walk);
+    } else {
+        printf("%-16s bytes: whitespace %d, comments %d, strings %d, numbers %d, literals %d\n", "",
+               (int)s->bytes_whitespace, (int)s->bytes_comments, (int)s->bytes_strings,
+               (int)s->bytes_numbers, (int)s->bytes_literals);
+        printf("%-16s max depth %d, longest close walk %d tokens\n", "", (int)s->max_depth,
+               (int)s->max_close_walk);
+    }
+}
+#endif
+
+// keys of the document and their objects, for the seek/get test
+static int collect_samples(cj5_result* r, sample* samples, char* keys, int keys_size)
+{
+    int num_samples = 0;
+    int keys_len = 0;
+    cj5_int step = r->num_tokens / NUM_SAMPLES + 1;
+    for (cj5_int i = 1; i < r->num_tokens && num_samples < NUM_SAMPLES; i += step) {
+        // move forward to the next key
+        while (i < r->num_tokens && (r->tokens[i].type != CJ5_TOKEN_STRING ||
+                                     r->tokens[i].size != 1 || r->tokens[i].escaped ||
+                                     r->tokens[r->tokens[i].parent_id].type != CJ5_TOKEN_OBJECT)) {
+            i++;
+        }
+        if (i == r->num_tokens) {
+            break;
+        }
+
+        int len = (int)(r->tokens[i].end - r->tokens[i].start);
+        if (keys_len + len + 1 > keys_size) {
+            break;
+        }
+        memcpy(&keys[keys_len], &r->json5[r->tokens[i].start], (size_t)len);
+        keys[keys_len + len] = '\0';
+        samples[num_samples].parent_id = r->tokens[i].parent_id;
+        samples[num_samples].key = &keys[keys_len];
+        num_samples++;
+        keys_len += len + 1;
+    }
+    return num_samples;
+}
+
+// average time of cj5_seek + reading the value
+static double measure_seek(cj5_result* r, const sample* samples, int num_samples, double* checksum)
+{
+    if (num_samples == 0) {
+        return 0;
+    }
+
+    int64_t num_ops = 0;
+    double start = now();
+    double elapsed;
+    do {
+        for (int i = 0; i < num_samples; i++) {
+            cj5_int id = cj5_seek(r, samples[i].parent_id, samples[i].key);
+            switch (r->tokens[id].type) {
+            case CJ5_TOKEN_NUMBER:
+                *checksum += cj5_get_double(r, id);
+                break;
+            case CJ5_TOKEN_BOOL:
+                *checksum += cj5_get_bool(r, id);
+                break;
+            case CJ5_TOKEN_STRING: {
+                cj5_int len;
+                cj5_get_string_view(r, id, &len);
+                *checksum += (double)len;
+                break;
+            }
+            default:
+                *checksum += (double)r->tokens[id].size;
+                break;
+            }
+        }
+        num_ops += num_samples;
+        elapsed = now() - start;
+    } while (elapsed < MIN_SECONDS / 2);
+    return elapsed / (double)num_ops * 1e9;
+}
+
+typedef void (*parse_fn)(const corpus* c, void* tokens, int max_tokens);
+
+static void parse_cj5(const corpus* c, void* tokens, int max_tokens)
+{
+    cj5_parse(c->data, c->len, (cj5_token*)tokens, max_tokens);
+}
+
+static void validate_cj5(const corpus* c, void* tokens, int max_tokens)
+{
+    (void)tokens;
+    (void)max_tokens;
+    cj5_validate(c->data, c->len);
+}
+
+static void count_cj5(const corpus* c, void* tokens, int max_tokens)
+{
+    (void)tokens;
+    (void)max_tokens;
+    cj5_count_tokens(c->data, c->len, NULL, NULL);
+}
+
+#if BENCH_JSMN
+static void parse_jsmn(const corpus* c, void* tokens, int max_tokens)
+{
+    jsmn_parser p;
+    jsmn_init(&p);
+    jsmn_parse(&p, c->data, (size_t)c->len, (jsmntok_t*)tokens, (unsigned)max_tokens);
+}
+#endif
+
+// fastest time of one parse. small documents are parsed many times per run, so the clock
+// resolution doesn't matter
+static double measure_parse(parse_fn fn, const corpus* c, void* tokens, int max_tokens)
+{
+    int runs = 1;
+    double t;
+    for (;;) {
+        t = now();
+        for (int i = 0; i < runs; i++) {
+            fn(c, tokens, max_tokens);
+        }
+        t = now() - t;
+        if (t >= 0.01) {
+            break;
+        }
+        runs *= 2;
+    }
+
+    double best = t / runs;
+    double start = now();
+    while (now() - start < MIN_SECONDS) {
+        t = now();
+        for (int i = 0; i < runs; i++) {
+            fn(c, tokens, max_tokens);
+        }
+        t = (now() - t) / runs;
+        best = t < best ? t : best;
+    }
+    return best;
+}
+
+static void bench_corpus(const corpus* c)
+{
+    cj5_result r = cj5_parse(c->data, c->len, NULL, 0);
+    cj5_int num_tokens = r.num_tokens;
+    cj5_token* tokens = (cj5_token*)malloc(sizeof(cj5_token) * (size_t)num_tokens);
+    r = cj5_parse(c->data, c->len, tokens, num_tokens);
+    if (r.error != CJ5_ERROR_NONE) {
+        fprintf(stderr, "%s: parse error %d, line: %d, col: %d\n", c->name, r.error,
+                (int)r.error_line, (int)r.error_col);
+        free(tokens);
+        return;
+    }
+    double seconds = measure_parse(parse_cj5, c, tokens, (int)num_tokens);
+
+    static sample samples[NUM_SAMPLES];
+    static char keys[NUM_SAMPLES * 64];
+    double checksum = 0;
+    int num_samples = collect_samples(&r, samples, keys, (int)sizeof(keys));
+    double seek_ns = measure_seek(&r, samples, num_samples, &checksum);
+
+    cj5_int index_size = cj5_build_index(&r, NULL, 0);
+    void* index = malloc((size_t)index_size);
+    cj5_build_index(&r, index, index_size);
+    double seek_index_ns = measure_seek(&r, samples, num_samples, &checksum);
+    report(c, "cj5", num_tokens, seconds, seek_ns, seek_index_ns);
+#if CJ5_STATS
+    report_stats(c, &r.stats);
+#endif
+    free(index);
+    free(tokens);
+
+    // same document without building tokens
+    seconds = measure_parse(validate_cj5, c, NULL, 0);
+    report(c, "validate", num_tokens, seconds, 0, 0);
+
+    // only the number of tokens, for allocating them before the parse
+    seconds = measure_parse(count_cj5, c, NULL, 0);
+    report(c, "count", cj5_count_tokens(c->data, c->len, NULL, NULL), seconds, 0, 0);
+
+#if BENCH_JSMN
+    if (!c->json5) {
+        jsmn_parser p;
+        jsmn_init(&p);
+        int num_jsmn = jsmn_parse(&p, c->data, (size_t)c->len, NULL, 0);
+        if (num_jsmn < 0) {
+            fprintf(stderr, "%s: jsmn error %d\n", c->name, num_jsmn);
+            return;
+        }
+
+        jsmntok_t* jtokens = (jsmntok_t*)malloc(sizeof(jsmntok_t) * (size_t)num_jsmn);
+        seconds = measure_parse(parse_jsmn, c, jtokens, num_jsmn);
+        report(c, "jsmn", num_jsmn, seconds, 0, 0);
+        free(jtokens);
+    }
+#endif
+
+    if (checksum == 12345.678) {
+        printf("\n");    // keeps the lookups from being optimized out
+    }
+}
+
+static int load_file(corpus* c, const char* filepath)
+{
+    FILE* f = fopen(filepath, "rb");
+    if (!f) {
+        return 0;
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    c->data = (char*)malloc((size_t)size + 1);
+    c->len = (int)fread(c->data, 1, (size_t)size, f);
+    c->data[c->len] = '\0';
+    c->name = filepath;
+    fclose(f);
+
+    // comments, single quotes or unquoted keys are checked by jsmn anyway, this only skips the
+    // files that are obviously JSON5
+    const char* ext = strrchr(filepath, '.');
+    c->json5 = ext && strcmp(ext, ".json5") == 0;
+    return 1;
+}
+
+int main(int argc, char* argv[])
+{
+    int size = 4 << 20;
+    int first_file = argc;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--json") == 0) {
+            g_json_output = 1;
+        } else if (strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            // the generator doubles an `int` capacity, so stay well below 2GB
+            char* end;
+            long mb = strtol(argv[++i], &end, 10);
+            if (end == argv[i] || *end != '\0' || mb < 1 || mb > 256) {
+                fprintf(stderr, "--size must be a number of MB between 1 and 256\n");
+                return 1;
+            }
+            size = (int)mb << 20;
+        } else {
+            first_file = i;
+            break;
+        }
+    }
+
+    static void (*const generators[])(buffer*, int) = { gen_twitter, gen_canada, gen_citm,
+                                                         gen_nested, gen_json5 };
+    static const char* names[] = { "twitter", "canada", "citm_catalog", "nested", "json5_config" };
+
+    if (!g_json_output) {
+        printf("%-16s %-8s %12s %10s %13s %15s %11s %11s\n", "corpus", "parser", "size", "tokens",
+               "throughput", "", "seek+get", "(index)");
+    }
+
+    for (int i = 0; i < 5; i++) {
+        buffer b = { NULL, 0, 0 };
+        generators[i](&b, size);
+        put(&b, "\n");    // a number at the end of the document needs a terminator
+        corpus c = { names[i], b.data, b.len, i == 4 };
+        bench_corpus(&c);
+        free(b.data);
+    }
+
+    for (int i = first_file; i < argc; i++) {
+        corpus c;
+        if (!load_file(&c, argv[i])) {
+            fprintf(stderr, "can't open %s\n", argv[i]);
+            continue;
+        }
+        bench_corpus(&c);
+        free(c.data);
+    }
+    return 0;
+}
@@ -0,0 +1,83 @@
+// compares memory use and lookup speed of the full and compact token layouts (see `cj5_compact`)
+// build: cc -O2 bench_compact.c -o bench_compact -lm
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define CJ5_IMPLEMENT
+#include "../cj5.h"
+
+#define NUM_OBJECTS 200000
+#define NUM_ROUNDS 20
+
+static const char* g_keys[] = { "id", "name", "score", "tags", "active", "x", "y", "z" };
+
+static char* make_document(int* len)
+{
+    char* json = (char*)malloc((size_t)NUM_OBJECTS * 128 + 16);
+    int n = 0;
+    json[n++] = '[';
+    for (int i = 0; i < NUM_OBJECTS; i++) {
+        n += sprintf(&json[n],
+                     "%s{id:%d,name:\"item%d\",score:%d.5,tags:[%d,%d],active:%s,x:1,y:2,z:3}",
+                     i ? "," : "", i, i, i % 100, i & 7, i & 15, (i & 1) ? "true" : "false");
+    }
+    json[n++] = ']';
+    json[n] = '\0';
+    *len = n;
+    return json;
+}
+
+// seeks a few keys of every object and reads their values, like a typical loader would
+static double run_lookups(cj5_result* r, int64_t* checksum)
+{
+    clock_t start = clock();
+    int64_t sum = 0;
+    for (int round = 0; round < NUM_ROUNDS; round++) {
+        cj5_int elem = -1;
+        int index = 0;
+        while ((elem = cj5_get_array_elem_incremental(r, 0, index++, elem)) != -1) {
+            sum += cj5_seekget_int(r, elem, "id", 0);
+            sum += (int64_t)cj5_seekget_double(r, elem, "score", 0);
+            sum += cj5_seekget_bool(r, elem, "active", false);
+            sum += cj5_seekget_int(r, elem, g_keys[5 + (index % 3)], 0);
+        }
+    }
+    *checksum = sum;
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+int main()
+{
+    int len;
+    char* json = make_document(&len);
+
+    cj5_result r = cj5_parse(json, len, NULL, 0);
+    cj5_int num_tokens = r.num_tokens;
+    cj5_token* tokens = (cj5_token*)malloc(sizeof(cj5_token) * (size_t)num_tokens);
+    r = cj5_parse(json, len, tokens, num_tokens);
+    if (r.error) {
+        printf("ERROR: %d\n", r.error);
+        return 1;
+    }
+
+    int64_t full_sum, compact_sum;
+    double full_time = run_lookups(&r, &full_sum);
+    cj5_int full_size = num_tokens * (cj5_int)sizeof(cj5_token);
+
+    // convert in place, the memory after the compact tokens can be freed or reused
+    cj5_int compact_size = cj5_compact(&r, tokens, full_size);
+    double compact_time = run_lookups(&r, &compact_sum);
+
+    printf("document: %d bytes, %d tokens\n", len, (int)num_tokens);
+    printf("full:    %10.2f MB, %.3f s\n", (double)full_size / (1024 * 1024), full_time);
+    printf("compact: %10.2f MB, %.3f s\n", (double)compact_size / (1024 * 1024), compact_time);
+    if (full_sum != compact_sum) {
+        printf("ERROR: results differ\n");
+        return 1;
+    }
+
+    free(tokens);
+    free(json);
+    return 0;
+}
@@ -0,0 +1,114 @@
+// compares the C++ wrapper (cj5.hpp) with the same loops written against the C API
+// build: c++ -std=c++17 -O2 bench_cpp.cpp -o bench_cpp
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define CJ5_IMPLEMENT
+#include "../cj5.h"
+#include "../cj5.hpp"
+
+using namespace cj5::literals;
+
+#define NUM_OBJECTS 200000
+#define NUM_ROUNDS 20
+
+// keys are hashed at compile time
+static_assert("id"_key.hash == cj5::hash("id"), "");
+
+static char* make_document(int* len)
+{
+    char* json = (char*)malloc((size_t)NUM_OBJECTS * 128 + 16);
+    int n = 0;
+    json[n++] = '[';
+    for (int i = 0; i < NUM_OBJECTS; i++) {
+        n += sprintf(&json[n], "%s{id:%d,name:\"item%d\",score:%d.5,tags:[%d,%d,%d],active:%s}",
+                     i ? "," : "", i, i, i % 100, i & 7, i & 15, i & 31, (i & 1) ? "true" : "false");
+    }
+    json[n++] = ']';
+    json[n] = '\0';
+    *len = n;
+    return json;
+}
+
+static int64_t run_c(cj5_result* r)
+{
+    static const uint32_t id_hash = cj5::hash("id");
+    static const uint32_t score_hash = cj5::hash("score");
+    static const uint32_t tags_hash = cj5::hash("tags");
+    static const uint32_t active_hash = cj5::hash("active");
+
+    int64_t sum = 0;
+    const cj5_token* tokens = r->tokens;
+    for (cj5_int i = 1; i < tokens[0].next_id; i = tokens[i].next_id) {
+        sum += cj5_get_int64(r, cj5_seek_hash(r, i, id_hash));
+        sum += (int64_t)cj5_get_double(r, cj5_seek_hash(r, i, score_hash));
+        sum += cj5_get_bool(r, cj5_seek_hash(r, i, active_hash));
+        cj5_int tags = cj5_seek_hash(r, i, tags_hash);
+        for (cj5_int t = tags + 1; t < tokens[tags].next_id; t = tokens[t].next_id) {
+            sum += cj5_get_int(r, t);
+        }
+    }
+    return sum;
+}
+
+static int64_t run_cpp(cj5_result* r)
+{
+    int64_t sum = 0;
+    for (cj5::value obj : cj5::root(*r).elements()) {
+        sum += obj["id"_key].as_int64();
+        sum += (int64_t)obj["score"_key].as_double();
+        sum += obj["active"_key].as_bool();
+        for (cj5::value tag : obj["tags"_key].elements()) {
+            sum += tag.as_int();
+        }
+    }
+    return sum;
+}
+
+template <typename F>
+static double measure(F fn, cj5_result* r, int64_t* checksum)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < NUM_ROUNDS; round++) {
+        *checksum = fn(r);
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main()
+{
+    int len;
+    char* json = make_document(&len);
+
+    cj5_result r = cj5_parse(json, len, NULL, 0);
+    cj5_int num_tokens = r.num_tokens;
+    cj5_token* tokens = (cj5_token*)malloc(sizeof(cj5_token) * (size_t)num_tokens);
+    r = cj5_parse(json, len, tokens, num_tokens);
+    if (r.error) {
+        printf("ERROR: %d\n", r.error);
+        return 1;
+    }
+
+    int64_t c_sum, cpp_sum;
+    double c_time = measure(run_c, &r, &c_sum);
+    double cpp_time = measure(run_cpp, &r, &cpp_sum);
+    printf("document: %d bytes, %d tokens\n", len, (int)num_tokens);
+    printf("C:   %.3f s\n", c_time);
+    printf("C++: %.3f s\n", cpp_time);
+    if (c_sum != cpp_sum) {
+        printf("ERROR: results differ\n");
+        return 1;
+    }
+
+    // range-for over members, with structured bindings
+    cj5::value first = cj5::root(r)[0];
+    for (auto [key, val] : first.members()) {
+        std::string_view name = key.as_string_view();
+        printf("%.*s: type %d\n", (int)name.size(), name.data(), (int)val.type());
+    }
+
+    free(tokens);
+    free(json);
+    return 0;
+}
@@ -0,0 +1,974 @@
+// checks that the other ways to parse a document give the same result as `cj5_parse`, on fixed
+// documents that cover comments, escapes, JSON5 syntax and errors: streaming with every split,
+// parallel chunks, edits at every position, validation and token counting.
+// then checks the features one by one on small documents. returns 1 if any check fails
+// build: cc -O2 check.c -o check -lm, or `make check` in the repo root
+//        with parse statistics: cc -O2 -DCJ5_STATS=1 check.c -o check -lm
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CJ5_IMPLEMENT
+#include "../cj5.h"
+
+#define MAX_TOKENS 256
+
+static const char* g_docs[] = {
+    "{}",
+    "[1, 2.5, -3, 0x1F, 1e5, .5, +1, null, true, false]",
+    "{\"a\": \"x\", 'b': 'it\\'s', c: \"\\u00e9\\n\\\"\", d: \"\\\n\"}",
+    "{\n  // line comment\n  name: 'cj5', /* block */ list: [1, {k: null}, []],\n}\n",
+    "[\n/* abcdef */ 1]",
+    "[\n/* a * b ** c */\n// x\r\n/**/ 2, /*/ odd */ 3]",
+    "{\n  deep: {a: {b: {c: [[[\"s\"]], {d: 'e'}]}}},\n  // end\n}",
+    "{key_1: \"a long string value that is cut at many places\", _k: 'single \"quoted\"'}",
+    "[1, 2]\n// trailing comment",
+    "[1, 2] /* trailing block */",
+    "42",
+    "\"abc",
+    "[\"abc",
+    "{a: 1",
+    "[1, 2, @]",
+    "{\"a\": \"\\q\"}",
+    "[\n/* never closed",
+    "[1, 2]\n// comment without a line break",
+};
+
+#define NUM_DOCS (int)(sizeof(g_docs) / sizeof(g_docs[0]))
+
+static int g_num_checks;
+static int g_num_failed;
+
+static void check(bool ok, const char* what, int doc, cj5_int at)
+{
+    g_num_checks++;
+    if (!ok) {
+        g_num_failed++;
+        printf("FAILED: %s, document %d, at %d\n", what, doc, (int)at);
+    }
+}
+
+// single checks of the features, prints the expression that failed
+#define CHECK(_expr) check_expr((_expr), #_expr, __LINE__)
+
+static void check_expr(bool ok, const char* expr, int line)
+{
+    g_num_checks++;
+    if (!ok) {
+        g_num_failed++;
+        printf("FAILED: %s, line %d\n", expr, line);
+    }
+}
+
+static cj5_result parse(const char* json, cj5_token* tokens)
+{
+    return cj5_parse(json, (cj5_int)strlen(json), tokens, MAX_TOKENS);
+}
+
+static bool same_result(const cj5_result* a, const cj5_result* b)
+{
+    if (a->error != b->error || a->error_line != b->error_line || a->error_col != b->error_col ||
+        a->num_tokens != b->num_tokens) {
+        return false;
+    }
+    if (a->error != CJ5_ERROR_NONE) {
+        return true;
+    }
+
+    for (cj5_int i = 0; i < a->num_tokens; i++) {
+        const cj5_token* x = &a->tokens[i];
+        const cj5_token* y = &b->tokens[i];
+        if (x->type != y->type || x->start != y->start || x->end != y->end || x->size != y->size ||
+            x->parent_id != y->parent_id || x->next_id != y->next_id || x->escaped != y->escaped ||
+            x->key_start != y->key_start || x->key_end != y->key_end) {
+            return false;
+        }
+        if ((x->type == CJ5_TOKEN_NUMBER && x->num_type != y->num_type) ||
+            (x->type == CJ5_TOKEN_STRING && x->key_hash != y->key_hash)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#if CJ5_STATS
+static bool same_stats(const cj5_stats* a, const cj5_stats* b)
+{
+    // cycles depend on the run
+    return a->bytes_whitespace == b->bytes_whitespace && a->bytes_comments == b->bytes_comments &&
+           a->bytes_strings == b->bytes_strings && a->bytes_numbers == b->bytes_numbers &&
+           a->bytes_literals == b->bytes_literals && a->max_depth == b->max_depth &&
+           a->max_close_walk == b->max_close_walk &&
+           memcmp(a->num_tokens, b->num_tokens, sizeof(a->num_tokens)) == 0;
+}
+#endif
+
+static void check_stream(const char* json, cj5_int len, const cj5_result* expected, int doc,
+                         cj5_int split)
+{
+    cj5_token tokens[MAX_TOKENS];
+    cj5_parser parser;
+    cj5_parser_init(&parser, tokens, MAX_TOKENS);
+    if (split < 0) {
+        // one byte at a time
+        for (cj5_int n = 1; n < len; n++) {
+            cj5_parser_feed(&parser, json, n);
+        }
+    } else {
+        cj5_parser_feed(&parser, json, split);
+    }
+    cj5_result r = cj5_parser_finish(&parser, json, len);
+    check(same_result(expected, &r), "cj5_parser_feed", doc, split);
+#if CJ5_STATS
+    check(same_stats(&expected->stats, &r.stats), "cj5_parser_feed stats", doc, split);
+#endif
+}
+
+static void* check_realloc(void* ptr, size_t size, void* user)
+{
+    (void)user;
+    if (size == 0) {
+        free(ptr);
+        return NULL;
+    }
+    return realloc(ptr, size);
+}
+
+// runs the tasks one after another, the chunks are the same as on a thread pool
+static void check_dispatch(cj5_task_fn* task, void* data, int count, void* user)
+{
+    (void)user;
+    for (int i = 0; i < count; i++) {
+        task(data, i);
+    }
+}
+
+static void check_parallel(const char* json, cj5_int len, const cj5_result* expected, int doc)
+{
+    cj5_token tokens[MAX_TOKENS];
+    for (int num_chunks = 2; num_chunks <= 5; num_chunks++) {
+        cj5_parallel_desc desc = { 0 };
+        desc.num_chunks = num_chunks;
+        desc.min_chunk_size = 1;
+        desc.dispatch_fn = check_dispatch;
+        desc.realloc_fn = check_realloc;
+        cj5_result r = cj5_parse_parallel(json, len, tokens, MAX_TOKENS, &desc);
+        check(same_result(expected, &r), "cj5_parse_parallel", doc, num_chunks);
+    }
+}
+
+// deletes the byte at `pos`, or inserts `insert` before it, then compares the edit with a new parse
+static void check_edit(const char* json, cj5_int len, int doc, cj5_int pos, const char* insert)
+{
+    static char edited[1024];
+    cj5_token old_tokens[MAX_TOKENS];
+    cj5_token tokens[MAX_TOKENS];
+    cj5_result old = cj5_parse(json, len, old_tokens, MAX_TOKENS);
+
+    cj5_edit edit;
+    edit.start = pos;
+    edit.end = insert ? pos : pos + 1;
+    edit.new_len = insert ? (cj5_int)strlen(insert) : 0;
+    memcpy(edited, json, (size_t)pos);
+    memcpy(&edited[pos], insert ? insert : "", (size_t)edit.new_len);
+    memcpy(&edited[pos + edit.new_len], &json[edit.end], (size_t)(len - edit.end));
+    cj5_int edited_len = len - (edit.end - edit.start) + edit.new_len;
+
+    cj5_result expected = cj5_parse(edited, edited_len, tokens, MAX_TOKENS);
+    cj5_result r = cj5_parse_edit(edited, edited_len, old_tokens, MAX_TOKENS, &old, &edit);
+    check(same_result(&expected, &r), insert ? "cj5_parse_edit insert" : "cj5_parse_edit delete",
+          doc, pos);
+}
+
+static void check_validate(const char* json, cj5_int len, const cj5_result* expected, int doc)
+{
+    cj5_result r = cj5_validate(json, len);
+    check(r.error == expected->error && r.error_line == expected->error_line &&
+              r.error_col == expected->error_col &&
+              (r.error != CJ5_ERROR_NONE || r.num_tokens == expected->num_tokens),
+          "cj5_validate", doc, 0);
+}
+
+// the count is only exact for documents that `cj5_parse` accepts
+static void check_count(const char* json, cj5_int len, const cj5_result* expected, int doc)
+{
+    cj5_int max_depth = 0;
+    cj5_int string_bytes = 0;
+    for (cj5_int i = 0; i < expected->num_tokens; i++) {
+        const cj5_token* tok = &expected->tokens[i];
+        if (tok->type == CJ5_TOKEN_STRING) {
+            string_bytes += tok->end - tok->start;
+        } else if (tok->type == CJ5_TOKEN_OBJECT || tok->type == CJ5_TOKEN_ARRAY) {
+            cj5_int depth = 1;
+            for (cj5_int p = tok->parent_id; p != -1; p = expected->tokens[p].parent_id) {
+                depth += expected->tokens[p].type != CJ5_TOKEN_STRING;
+            }
+            max_depth = depth > max_depth ? depth : max_depth;
+        }
+    }
+
+    cj5_int count_depth, count_bytes;
+    cj5_int count = cj5_count_tokens(json, len, &count_depth, &count_bytes);
+    check(count == expected->num_tokens && count_depth == max_depth && count_bytes == string_bytes,
+          "cj5_count_tokens", doc, 0);
+}
+
+static void check_docs(void)
+{
+    static cj5_token tokens[MAX_TOKENS];
+    for (int d = 0; d < NUM_DOCS; d++) {
+        const char* json = g_docs[d];
+        cj5_int len = (cj5_int)strlen(json);
+        cj5_result expected = cj5_parse(json, len, tokens, MAX_TOKENS);
+
+        // every split point, so strings, numbers and comments are cut everywhere
+        for (cj5_int split = 0; split <= len; split++) {
+            check_stream(json, len, &expected, d, split);
+        }
+        check_stream(json, len, &expected, d, -1);
+
+        check_parallel(json, len, &expected, d);
+        check_validate(json, len, &expected, d);
+        if (expected.error == CJ5_ERROR_NONE) {
+            check_count(json, len, &expected, d);
+            for (cj5_int pos = 0; pos < len; pos++) {
+                check_edit(json, len, d, pos, NULL);
+                check_edit(json, len, d, pos, "1");
+                check_edit(json, len, d, pos, ", {x: [2]}");
+            }
+        }
+    }
+}
+
+// numbers that are too long for the fast paths are still rounded correctly
+static void check_doubles(void)
+{
+    static char json[1024];
+    cj5_token tokens[MAX_TOKENS];
+
+    // 2^53 + 1 followed by a nonzero digit far behind, rounds up to 2^53 + 2
+    int n = sprintf(json, "[9007199254740993.");
+    memset(&json[n], '0', 831);
+    n += 831;
+    n += sprintf(&json[n], "1]");
+    cj5_result r = parse(json, tokens);
+    CHECK(r.error == CJ5_ERROR_NONE && cj5_get_double(&r, 1) == 9007199254740994.0);
+
+    // the same digits without a decimal point, moved back by the exponent
+    n = sprintf(json, "[9007199254740993");
+    memset(&json[n], '0', 818);
+    n += 818;
+    n += sprintf(&json[n], "1e-819]");
+    r = parse(json, tokens);
+    CHECK(r.error == CJ5_ERROR_NONE && cj5_get_double(&r, 1) == 9007199254740994.0);
+
+    r = parse("[0.1, -2.5e-3, 1e308, 4.9e-324, 0.000001234, 123456789012345678901234567890]",
+              tokens);
+    CHECK(cj5_get_double(&r, 1) == 0.1 && cj5_get_double(&r, 2) == -2.5e-3);
+    CHECK(cj5_get_double(&r, 3) == 1e308 && cj5_get_double(&r, 4) == 4.9e-324);
+    CHECK(cj5_get_double(&r, 5) == 0.000001234);
+    CHECK(cj5_get_double(&r, 6) == 123456789012345678901234567890.0);
+}
+
+// the writer reports the size it needs, then writes the same text into a buffer of that size
+static void check_writer_size(void)
+{
+    cj5_token tokens[MAX_TOKENS];
+    cj5_result r = parse(g_docs[6], tokens);
+    CHECK(r.error == CJ5_ERROR_NONE);
+
+    cj5_writer w;
+    cj5_writer_init(&w, NULL, 0);
+    cj5_write_token(&w, &r, 0);
+    CHECK(cj5_writer_finish(&w) == CJ5_ERROR_OVERFLOW);
+    cj5_int size = w.len;
+
+    char* buf = (char*)malloc((size_t)size);
+    cj5_writer_init(&w, buf, size - 1);
+    cj5_write_token(&w, &r, 0);
+    CHECK(cj5_writer_finish(&w) == CJ5_ERROR_OVERFLOW && w.len == size);
+
+    cj5_writer_init(&w, buf, size);
+    cj5_write_token(&w, &r, 0);
+    CHECK(cj5_writer_finish(&w) == CJ5_ERROR_NONE && w.len == size - 1);
+    CHECK(strlen(buf) == (size_t)size - 1);
+    free(buf);
+
+    // the needed size stops at the largest `cj5_int` instead of wrapping around
+    cj5_int max_len = CJ5_LARGE ? INT64_MAX : INT32_MAX;
+    cj5_writer_init(&w, NULL, 0);
+    w.len = max_len - 2;
+    cj5_write_string(&w, "abcd", -1);
+    CHECK(cj5_writer_finish(&w) == CJ5_ERROR_OVERFLOW && w.len == max_len);
+}
+
+// writes the tokens of every valid document, parses the output and writes it again, the second
+// output must be the same as the first. pretty output must parse to the same tokens
+static cj5_int write_token(const char* json, char* out, cj5_int size, bool json5, int indent)
+{
+    cj5_token tokens[MAX_TOKENS];
+    cj5_result r = parse(json, tokens);
+    if (r.error != CJ5_ERROR_NONE) {
+        return -1;
+    }
+    cj5_writer w;
+    cj5_writer_init(&w, out, size);
+    w.json5 = json5;
+    w.indent = indent;
+    cj5_write_token(&w, &r, 0);
+    return cj5_writer_finish(&w) == CJ5_ERROR_NONE ? r.num_tokens : -1;
+}
+
+static void check_write_token(void)
+{
+    static char out[3][1024];
+    cj5_token tokens[MAX_TOKENS];
+    for (int d = 0; d < NUM_DOCS; d++) {
+        cj5_result r = parse(g_docs[d], tokens);
+        cj5_int num_tokens = r.num_tokens;
+        if (r.error != CJ5_ERROR_NONE) {
+            continue;
+        }
+        for (int json5 = 0; json5 < 2; json5++) {
+            CHECK(write_token(g_docs[d], out[0], 1024, json5, 0) == num_tokens);
+            CHECK(write_token(out[0], out[1], 1024, json5, 0) == num_tokens);
+            CHECK(strcmp(out[0], out[1]) == 0);
+            CHECK(write_token(out[0], out[2], 1024, json5, 2) == num_tokens);
+            CHECK(write_token(out[2], out[1], 1024, json5, 0) == num_tokens);
+            CHECK(strcmp(out[0], out[1]) == 0);
+        }
+    }
+}
+
+// doubles written by the writer are parsed back to the same bits
+static void check_write_double(const double* values, int count)
+{
+    static char buf[64 * 32];
+    cj5_token tokens[MAX_TOKENS];
+    cj5_writer w;
+    cj5_writer_init(&w, buf, (cj5_int)sizeof(buf));
+    cj5_write_begin_array(&w);
+    for (int i = 0; i < count; i++) {
+        cj5_write_double(&w, values[i]);
+    }
+    cj5_write_end_array(&w);
+    CHECK(cj5_writer_finish(&w) == CJ5_ERROR_NONE);
+
+    cj5_result r = parse(buf, tokens);
+    CHECK(r.error == CJ5_ERROR_NONE && r.num_tokens == count + 1);
+    for (int i = 0; i < count && i + 1 < r.num_tokens; i++) {
+        double value = cj5_get_double(&r, i + 1);
+        CHECK(memcmp(&value, &values[i], sizeof(double)) == 0);
+    }
+}
+
+static void check_write_doubles(void)
+{
+    static const double values[] = {
+        0.0, 1.0, -1.0, 0.1, 0.3, 1.0 / 3.0, 2.5e-3, 1e21, 1e22, 123456789.125, 5e-324,
+        2.2250738585072014e-308, 1.7976931348623157e308, 9007199254740993.0, 4.35, 1e-7,
+    };
+    check_write_double(values, (int)(sizeof(values) / sizeof(values[0])));
+
+    // random bit patterns, without NaN and infinity
+    uint64_t x = 0x9E3779B97F4A7C15ull;
+    for (int n = 0; n < 100; n++) {
+        double random[32];
+        for (int i = 0; i < 32; i++) {
+            do {
+                x ^= x << 13;
+                x ^= x >> 7;
+                x ^= x << 17;
+            } while ((x >> 52 & 0x7ff) == 0x7ff);
+            memcpy(&random[i], &x, sizeof(double));
+        }
+        check_write_double(random, 32);
+    }
+}
+
+// integer arrays flag floats with a fraction, clamped values and the first element that is not a
+// number
+static void check_array_numbers(void)
+{
+    cj5_token tokens[MAX_TOKENS];
+    int values[8];
+    int64_t values64[8];
+    double doubles[8];
+    int invalid;
+
+    cj5_result r = parse("[1, 2.7, -0.5, 1e3, 3]", tokens);
+    CHECK(cj5_get_array_numbers(&r, 0, CJ5_ARRAY_INT, values, 8, &invalid) == 5 && invalid == 1);
+    CHECK(values[0] == 1 && values[1] == 2 && values[2] == 0 && values[3] == 1000 && values[4] == 3);
+    CHECK(cj5_get_array_numbers(&r, 0, CJ5_ARRAY_DOUBLE, doubles, 8, &invalid) == 5 &&
+          invalid == -1 && doubles[1] == 2.7);
+
+    r = parse("[1e3, -2.0, 0x10, 7]", tokens);
+    CHECK(cj5_get_array_numbers(&r, 0, CJ5_ARRAY_INT, values, 8, &invalid) == 4 && invalid == -1);
+    CHECK(values[0] == 1000 && values[1] == -2 && values[2] == 16 && values[3] == 7);
+
+    r = parse("[1, 4294967296, -1, \"x\", 2]", tokens);
+    CHECK(cj5_get_array_numbers(&r, 0, CJ5_ARRAY_INT, values, 8, &invalid) == 3 && invalid == 1);
+    CHECK(values[1] == INT32_MAX && values[2] == -1);
+    CHECK(cj5_get_array_numbers(&r, 0, CJ5_ARRAY_INT64, values64, 8, &invalid) == 3 &&
+          invalid == 3 && values64[1] == 4294967296ll);
+}
+
+// seeks on an indexed object find the same tokens as the linear search, duplicate keys resolve to
+// the first one in both
+static void check_index(void)
+{
+    static char json[2048];
+    static cj5_token tokens[MAX_TOKENS];
+    static void* mem[1024];
+    char key[16];
+
+    int n = sprintf(json, "{");
+    for (int i = 0; i < 40; i++) {
+        n += sprintf(&json[n], "key%d: %d, ", i, i);
+    }
+    sprintf(&json[n], "key7: -1, nested: {key3: 3}}");
+    cj5_result r = parse(json, tokens);
+    CHECK(r.error == CJ5_ERROR_NONE);
+
+    cj5_int ids[42];
+    for (int i = 0; i < 40; i++) {
+        sprintf(key, "key%d", i);
+        ids[i] = cj5_seek(&r, 0, key);
+    }
+    ids[40] = cj5_seek(&r, 0, "nested");
+    ids[41] = cj5_seek(&r, 0, "missing");
+
+    cj5_int size = cj5_build_index(&r, NULL, 0);
+    CHECK(size > 0 && size <= (cj5_int)sizeof(mem) && r.index == NULL);
+    CHECK(cj5_build_index(&r, mem, size) == size && r.index != NULL);
+    for (int i = 0; i < 40; i++) {
+        sprintf(key, "key%d", i);
+        CHECK(cj5_seek(&r, 0, key) == ids[i] && cj5_get_int(&r, ids[i]) == i);
+    }
+    CHECK(cj5_seek(&r, 0, "nested") == ids[40] && ids[40] != -1);
+    CHECK(cj5_seek(&r, 0, "missing") == -1 && ids[41] == -1);
+    CHECK(cj5_get_int(&r, cj5_seek(&r, ids[40], "key3")) == 3);
+}
+
+// the checked getters clamp numbers that don't fit in the type and report it
+static void check_integers(void)
+{
+    cj5_token tokens[MAX_TOKENS];
+    bool overflow;
+    cj5_result r = parse("[2147483647, 2147483648, -2147483648, -2147483649, 4294967295, -1, "
+                         "18446744073709551615, 18446744073709551616, 9223372036854775807, "
+                         "-9223372036854775809, 0xFFFFFFFFFFFFFFFF, 0x10000000000000000, 1e30]",
+                         tokens);
+    CHECK(r.error == CJ5_ERROR_NONE && r.num_tokens == 14);
+
+    CHECK(cj5_get_int_checked(&r, 1, &overflow) == INT32_MAX && !overflow);
+    CHECK(cj5_get_int_checked(&r, 2, &overflow) == INT32_MAX && overflow);
+    CHECK(cj5_get_int_checked(&r, 3, &overflow) == INT32_MIN && !overflow);
+    CHECK(cj5_get_int_checked(&r, 4, &overflow) == INT32_MIN && overflow);
+    CHECK(cj5_get_uint_checked(&r, 5, &overflow) == UINT32_MAX && !overflow);
+    CHECK(cj5_get_uint_checked(&r, 6, &overflow) == 0 && overflow);
+    CHECK(cj5_get_uint64_checked(&r, 7, &overflow) == UINT64_MAX && !overflow);
+    CHECK(cj5_get_uint64_checked(&r, 8, &overflow) == UINT64_MAX && overflow);
+    CHECK(cj5_get_int64_checked(&r, 9, &overflow) == INT64_MAX && !overflow);
+    CHECK(cj5_get_int64_checked(&r, 10, &overflow) == INT64_MIN && overflow);
+    CHECK(cj5_get_uint64_checked(&r, 11, &overflow) == UINT64_MAX && !overflow);
+    CHECK(cj5_get_uint64_checked(&r, 12, &overflow) == UINT64_MAX && overflow);
+    CHECK(cj5_get_int64_checked(&r, 13, &overflow) == INT64_MAX && overflow);
+
+    // the unchecked getters clamp the same way
+    CHECK(cj5_get_int(&r, 2) == INT32_MAX && cj5_get_uint(&r, 6) == 0);
+    CHECK(cj5_get_int(&r, 3) == INT32_MIN && cj5_get_int64(&r, 10) == INT64_MIN);
+}
+
+// escape sequences are decoded by `cj5_get_string` and `cj5_unescape`, also in place and cut at the
+// end of the buffer without splitting a UTF-8 sequence
+static void check_strings(void)
+{
+    cj5_token tokens[MAX_TOKENS];
+    char str[64];
+    cj5_int len;
+    cj5_result r = parse("[\"plain\", \"a\\tb\\\\c\\\"d\", 'it\\'s', "
+                         "\"\\u00e9\\u20ac\\ud83d\\ude00\", \"line\\\ncont\", \"\\ud800x\\/\"]",
+                         tokens);
+    CHECK(r.error == CJ5_ERROR_NONE && r.num_tokens == 7);
+
+    CHECK(strcmp(cj5_get_string(&r, 1, str, sizeof(str)), "plain") == 0);
+    CHECK(strcmp(cj5_get_string(&r, 2, str, sizeof(str)), "a\tb\\c\"d") == 0);
+    CHECK(strcmp(cj5_get_string(&r, 3, str, sizeof(str)), "it's") == 0);
+    CHECK(strcmp(cj5_get_string(&r, 4, str, sizeof(str)),
+                 "\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80") == 0);
+    CHECK(strcmp(cj5_get_string(&r, 5, str, sizeof(str)), "linecont") == 0);
+    CHECK(strcmp(cj5_get_string(&r, 6, str, sizeof(str)), "\xef\xbf\xbdx/") == 0);
+
+    // views point into the document, escaped strings need decoding
+    const char* view = cj5_get_string_view(&r, 1, &len);
+    CHECK(view == &r.json5[r.tokens[1].start] && len == 5);
+    CHECK(cj5_get_string_view(&r, 4, &len) == NULL && len == 24);
+
+    // "é" fits, the 3 bytes of "€" don't
+    CHECK(strcmp(cj5_get_string(&r, 4, str, 5), "\xc3\xa9") == 0);
+    CHECK(strcmp(cj5_get_string(&r, 1, str, 4), "pla") == 0);
+
+    // in place
+    char buf[] = "x\\u00e9\\n\\u0041yz";
+    len = cj5_unescape(buf, (cj5_int)sizeof(buf), buf, (cj5_int)strlen(buf));
+    CHECK(len == 7 && memcmp(buf, "x\xc3\xa9\nAyz", 7) == 0);
+}
+
+// newline delimited records: blank and comment lines are skipped, an invalid record doesn't stop
+// the others, and the parallel parse gives the same records
+static void check_records(void)
+{
+    static cj5_token tokens[MAX_TOKENS];
+    static cj5_token tokens_parallel[MAX_TOKENS];
+    cj5_record records[8];
+    cj5_record records_parallel[8];
+    const char* json = "{a: 1}\n\n[1, 2]\r\n{bad\n\"s\"\n// comment\n42\n";
+    cj5_int len = (cj5_int)strlen(json);
+
+    cj5_records_result rs = cj5_parse_records(json, len, tokens, MAX_TOKENS, records, 8);
+    CHECK(rs.num_records == 5 && rs.num_invalid == 1 && rs.error == CJ5_ERROR_INVALID);
+    CHECK(records[0].start == 0 && records[0].end == 6 && records[0].token_count == 3);
+    CHECK(records[1].start == 8 && records[1].end == 14 && records[1].token_count == 3);
+    CHECK(records[2].error == CJ5_ERROR_INVALID && records[2].token_count == 0);
+    CHECK(records[3].token_begin == records[1].token_begin + 3 && records[4].token_count == 1);
+
+    cj5_result r = cj5_get_record(&rs, 0);
+    CHECK(r.error == CJ5_ERROR_NONE && cj5_get_int(&r, cj5_seek(&r, 0, "a")) == 1);
+    r = cj5_get_record(&rs, 1);
+    CHECK(r.num_tokens == 3 && cj5_get_int(&r, 2) == 2);
+    r = cj5_get_record(&rs, 3);
+    char str[8];
+    CHECK(strcmp(cj5_get_string(&r, 0, str, sizeof(str)), "s") == 0);
+    r = cj5_get_record(&rs, 4);
+    CHECK(cj5_get_int(&r, 0) == 42);
+
+    cj5_parallel_desc desc = { 0 };
+    desc.num_chunks = 3;
+    desc.min_chunk_size = 1;
+    desc.dispatch_fn = check_dispatch;
+    desc.realloc_fn = check_realloc;
+    cj5_records_result rp = cj5_parse_records_parallel(json, len, tokens_parallel, MAX_TOKENS,
+                                                       records_parallel, 8, &desc);
+    CHECK(rp.num_records == rs.num_records && rp.num_tokens == rs.num_tokens &&
+          rp.num_invalid == rs.num_invalid && rp.error == rs.error);
+    for (int i = 0; i < 5; i++) {
+        const cj5_record* a = &records[i];
+        const cj5_record* b = &records_parallel[i];
+        CHECK(a->token_begin == b->token_begin && a->token_count == b->token_count &&
+              a->start == b->start && a->end == b->end && a->error == b->error);
+    }
+
+    // too few records, they are still counted
+    rs = cj5_parse_records(json, len, tokens, MAX_TOKENS, records, 2);
+    CHECK(rs.error == CJ5_ERROR_OVERFLOW && rs.num_records == 5);
+}
+
+#if CJ5_MMAP
+// parses `json` from a file, the result must be the same as parsing it from memory
+static void check_file_doc(const char* json, cj5_int len)
+{
+    static cj5_token tokens[MAX_TOKENS];
+    static cj5_token file_tokens[MAX_TOKENS];
+    const char* path = "check_file.json5";
+    FILE* f = fopen(path, "wb");
+    CHECK(f != NULL);
+    if (!f) {
+        return;
+    }
+    fwrite(json, 1, (size_t)len, f);
+    fclose(f);
+
+    cj5_file file;
+    cj5_result expected = cj5_parse(json, len, tokens, MAX_TOKENS);
+    cj5_result r = cj5_parse_file(&file, path, file_tokens, MAX_TOKENS);
+    CHECK(file.size == len && memcmp(file.data, json, (size_t)len) == 0);
+    CHECK((r.error != CJ5_ERROR_NONE || r.json5 == file.data) && same_result(&expected, &r));
+    cj5_file_close(&file);
+    remove(path);
+}
+
+// mapped files, also an empty one and one that ends at a page boundary (the parser can't read past
+// the end of the mapping)
+static void check_file(void)
+{
+    static char json[4096];
+    check_file_doc(g_docs[6], (cj5_int)strlen(g_docs[6]));
+    check_file_doc(g_docs[13], (cj5_int)strlen(g_docs[13]));
+    check_file_doc("", 0);
+
+    memset(json, ' ', sizeof(json));
+    json[0] = '[';
+    memcpy(&json[sizeof(json) - 9], "1, true]", 8);
+    json[sizeof(json) - 1] = '\n';
+    check_file_doc(json, (cj5_int)sizeof(json));
+    // a keyword that ends the file, it's incomplete without a line break
+    memset(json, ' ', sizeof(json));
+    memcpy(&json[sizeof(json) - 4], "true", 4);
+    check_file_doc(json, (cj5_int)sizeof(json));
+
+    cj5_file file;
+    cj5_token tokens[4];
+    cj5_result r = cj5_parse_file(&file, "check_file_that_does_not_exist.json5", tokens, 4);
+    CHECK(r.error == CJ5_ERROR_FILE);
+}
+#endif
+
+// compact tokens, converted in place: `cj5_get_token` gives back the full tokens and the helpers
+// return the same values
+static void check_compact(void)
+{
+    static cj5_token tokens[MAX_TOKENS];
+    static cj5_token full[MAX_TOKENS];
+    static char out[2][1024];
+    for (int d = 0; d < NUM_DOCS; d++) {
+        cj5_result r = parse(g_docs[d], tokens);
+        if (r.error != CJ5_ERROR_NONE) {
+            continue;
+        }
+        memcpy(full, tokens, sizeof(cj5_token) * (size_t)r.num_tokens);
+        cj5_result expected = r;
+        expected.tokens = full;
+
+        cj5_writer w;
+        cj5_writer_init(&w, out[0], (cj5_int)sizeof(out[0]));
+        cj5_write_token(&w, &r, 0);
+        cj5_writer_finish(&w);
+
+        cj5_int size = cj5_compact(&r, NULL, 0);
+        CHECK(size > 0 && size <= (cj5_int)sizeof(tokens) && r.tokens != NULL);
+        CHECK(cj5_compact(&r, tokens, size) == size && r.tokens == NULL && r.compact != NULL);
+
+        bool same = true;
+        for (cj5_int i = 0; i < r.num_tokens; i++) {
+            cj5_token a = cj5_get_token(&r, i);
+            const cj5_token* b = &full[i];
+            same &= a.type == b->type && a.start == b->start && a.end == b->end &&
+                    a.size == b->size && a.parent_id == b->parent_id &&
+                    a.next_id == b->next_id && a.escaped == b->escaped;
+            same &= cj5_get_type(&r, i) == b->type && cj5_get_next(&r, i) == b->next_id;
+            if (b->type == CJ5_TOKEN_NUMBER) {
+                same &= a.num_type == b->num_type &&
+                        cj5_get_double(&r, i) == cj5_get_double(&expected, i);
+            } else if (b->type == CJ5_TOKEN_STRING && b->size == 1) {
+                same &= a.key_hash == b->key_hash && r.key_hashes[i] == b->key_hash;
+            }
+        }
+        check(same, "cj5_compact", d, 0);
+
+        cj5_writer_init(&w, out[1], (cj5_int)sizeof(out[1]));
+        cj5_write_token(&w, &r, 0);
+        cj5_writer_finish(&w);
+        check(strcmp(out[0], out[1]) == 0, "cj5_compact cj5_write_token", d, 0);
+    }
+
+    cj5_result r = parse("{list: [1, 2, 3], name: \"x\\ty\"}", tokens);
+    cj5_compact(&r, tokens, cj5_compact(&r, NULL, 0));
+    char str[8];
+    cj5_int list = cj5_seek(&r, 0, "list");
+    CHECK(cj5_get_array_elem(&r, list, 2) == list + 3 && cj5_get_int(&r, list + 3) == 3);
+    CHECK(strcmp(cj5_seekget_string(&r, 0, "name", str, sizeof(str), ""), "x\ty") == 0);
+}
+
+// compiled paths resolve to the same tokens as seeks and array lookups, one at a time and in a
+// batch
+static void check_paths(void)
+{
+    static const char* strs[] = {
+        "render.passes[2].shader", "render.passes[0]", "list[1][0]", "", "render.missing",
+        "list[5]", "list.key", "render[0]", "render.passes[1].shader", "list[0][1]",
+    };
+    enum { NUM_PATHS = (int)(sizeof(strs) / sizeof(strs[0])) };
+    cj5_token tokens[MAX_TOKENS];
+    cj5_path paths[NUM_PATHS];
+    cj5_int ids[NUM_PATHS];
+    cj5_result r = parse("{render: {passes: [{shader: 'a'}, {shader: 'b'}, {shader: 'c'}]}, "
+                         "list: [[1, 2], [3]]}",
+                         tokens);
+    CHECK(r.error == CJ5_ERROR_NONE);
+
+    cj5_int render = cj5_seek(&r, 0, "render");
+    cj5_int passes = cj5_seek(&r, render, "passes");
+    cj5_int list = cj5_seek(&r, 0, "list");
+    cj5_int expected[NUM_PATHS] = {
+        cj5_seek(&r, cj5_get_array_elem(&r, passes, 2), "shader"),
+        cj5_get_array_elem(&r, passes, 0),
+        cj5_get_array_elem(&r, cj5_get_array_elem(&r, list, 1), 0),
+        0, -1, -1, -1, -1,
+        cj5_seek(&r, cj5_get_array_elem(&r, passes, 1), "shader"),
+        cj5_get_array_elem(&r, cj5_get_array_elem(&r, list, 0), 1),
+    };
+
+    for (int i = 0; i < NUM_PATHS; i++) {
+        CHECK(cj5_compile_path(&paths[i], strs[i]));
+        CHECK(cj5_query(&r, 0, &paths[i]) == expected[i]);
+    }
+    cj5_query_batch(&r, 0, paths, NUM_PATHS, ids);
+    CHECK(memcmp(ids, expected, sizeof(ids)) == 0);
+
+    char str[8];
+    CHECK(strcmp(cj5_get_string(&r, expected[0], str, sizeof(str)), "c") == 0);
+    CHECK(cj5_get_int(&r, expected[2]) == 3 && cj5_get_int(&r, expected[9]) == 2);
+
+    // relative to another token
+    CHECK(cj5_compile_path(&paths[0], "[1].shader"));
+    CHECK(cj5_query(&r, passes, &paths[0]) == expected[8]);
+
+    CHECK(!cj5_compile_path(&paths[0], "a..b") && !cj5_compile_path(&paths[0], "a["));
+    CHECK(!cj5_compile_path(&paths[0], "a[x]") && !cj5_compile_path(&paths[0], "a[1]b"));
+    CHECK(!cj5_compile_path(&paths[0], "a[99999999999]"));
+    // CJ5_PATH_MAX_STEPS = 16
+    CHECK(!cj5_compile_path(&paths[0], "a.b.c.d.e.f.g.h.i.j.k.l.m.n.o.p.q"));
+    CHECK(cj5_compile_path(&paths[0], "a.b.c.d.e.f.g.h.i.j.k.l.m.n.o.p"));
+}
+
+typedef struct check_size {
+    int w;
+    int h;
+} check_size;
+
+typedef struct check_settings {
+    double scale;
+    float gamma;
+    int width;
+    uint32_t flags;
+    int64_t offset;
+    uint64_t id;
+    bool vsync;
+    char title[8];
+    check_size size;
+    cj5_int extra;
+} check_settings;
+
+// binds every field type, with defaults for missing members and members of another type, the first
+// of duplicate keys, and a nested struct
+static void check_bind(void)
+{
+    static const cj5_field size_fields[] = {
+        { "w", CJ5_FIELD_INT, offsetof(check_size, w), 0, { .i = 640 }, NULL },
+        { "h", CJ5_FIELD_INT, offsetof(check_size, h), 0, { .i = 480 }, NULL },
+    };
+    static cj5_schema size_schema;
+    static const cj5_field fields[] = {
+        { "scale", CJ5_FIELD_DOUBLE, offsetof(check_settings, scale), 0, { .d = 1.0 }, NULL },
+        { "gamma", CJ5_FIELD_FLOAT, offsetof(check_settings, gamma), 0, { .d = 2.2 }, NULL },
+        { "width", CJ5_FIELD_INT, offsetof(check_settings, width), 0, { .i = 640 }, NULL },
+        { "flags", CJ5_FIELD_UINT, offsetof(check_settings, flags), 0, { .u = 7 }, NULL },
+        { "offset", CJ5_FIELD_INT64, offsetof(check_settings, offset), 0, { .i = -1 }, NULL },
+        { "id", CJ5_FIELD_UINT64, offsetof(check_settings, id), 0, { .u = 0 }, NULL },
+        { "vsync", CJ5_FIELD_BOOL, offsetof(check_settings, vsync), 0, { .b = false }, NULL },
+        { "title", CJ5_FIELD_STRING, offsetof(check_settings, title), 8, { .s = "none" }, NULL },
+        { "size", CJ5_FIELD_OBJECT, offsetof(check_settings, size), 0, { .i = 0 }, &size_schema },
+        { "extra", CJ5_FIELD_TOKEN, offsetof(check_settings, extra), 0, { .i = 0 }, NULL },
+    };
+    static cj5_schema schema;
+    static void* mem[2][64];
+    cj5_token tokens[MAX_TOKENS];
+
+    cj5_int size = cj5_schema_init(&size_schema, size_fields, 2, NULL, 0);
+    CHECK(size > 0 && size <= (cj5_int)sizeof(mem[0]));
+    CHECK(cj5_schema_init(&size_schema, size_fields, 2, mem[0], size) == size);
+    size = cj5_schema_init(&schema, fields, 10, NULL, 0);
+    CHECK(size > 0 && size <= (cj5_int)sizeof(mem[1]));
+    CHECK(cj5_schema_init(&schema, fields, 10, mem[1], size) == size);
+
+    cj5_result r = parse("{width: 1280, width: 1, scale: 2, gamma: 'bright', vsync: true, "
+                         "title: 'a long title', size: {w: 3}, extra: [1, 2], unknown: 5, "
+                         "id: 0xFFFFFFFFFFFFFFFF}",
+                         tokens);
+    CHECK(r.error == CJ5_ERROR_NONE);
+
+    check_settings s;
+    CHECK(cj5_bind(&r, 0, &schema, &s) == 7);
+    CHECK(s.width == 1280 && s.scale == 2.0 && s.gamma == 2.2f && s.vsync);
+    CHECK(s.flags == 7 && s.offset == -1 && s.id == UINT64_MAX);
+    CHECK(strcmp(s.title, "a long ") == 0);
+    CHECK(s.size.w == 3 && s.size.h == 480);
+    CHECK(s.extra == cj5_seek(&r, 0, "extra") && cj5_get_type(&r, s.extra) == CJ5_TOKEN_ARRAY);
+
+    // not an object, only the defaults
+    r = parse("[1]", tokens);
+    CHECK(cj5_bind(&r, 0, &schema, &s) == 0);
+    CHECK(s.width == 640 && strcmp(s.title, "none") == 0 && s.size.w == 640 && s.extra == -1);
+}
+
+// walks value `id` with the cursor, the members and elements must be the same as the tokens
+static bool cursor_walk(const cj5_cursor* c, cj5_result* r, cj5_int id)
+{
+    const cj5_token* tok = &r->tokens[id];
+    if (cj5_cursor_type(c) != tok->type) {
+        return false;
+    }
+    if (tok->type != CJ5_TOKEN_OBJECT && tok->type != CJ5_TOKEN_ARRAY) {
+        return true;
+    }
+
+    cj5_cursor child = *c;
+    cj5_int i = id + 1;
+    if (cj5_cursor_enter(&child)) {
+        do {
+            cj5_int value = i;
+            if (tok->type == CJ5_TOKEN_OBJECT) {
+                if (child.key_start != r->tokens[i].start || child.key_end != r->tokens[i].end) {
+                    return false;
+                }
+                value = i + 1;
+            }
+            if (value >= tok->next_id || !cursor_walk(&child, r, value)) {
+                return false;
+            }
+            i = r->tokens[i].next_id;
+        } while (cj5_cursor_next(&child));
+    }
+    return i == tok->next_id && child.error == CJ5_ERROR_NONE;
+}
+
+// the cursor reads the valid documents like the parser, and reads values on demand without
+// looking at the parts that are skipped
+static void check_cursor(void)
+{
+    static cj5_token tokens[MAX_TOKENS];
+    for (int d = 0; d < NUM_DOCS; d++) {
+        const char* json = g_docs[d];
+        cj5_result r = parse(json, tokens);
+        if (r.error == CJ5_ERROR_NONE) {
+            cj5_cursor c;
+            cj5_cursor_init(&c, json, (cj5_int)strlen(json));
+            check(cursor_walk(&c, &r, 0), "cj5_cursor", d, 0);
+        }
+    }
+
+    const char* json = "{\n  // settings\n  window: {width: 800, title: 'a\\nb'},\n"
+                       "  list: [1, /* 2 */ 'two', [3], null, true],\n"
+                       "  skip: {a: ']}\\'', b: [1, @]},\n  last: 0x10,\n}\n";
+    cj5_cursor root, c;
+    char str[8];
+    cj5_cursor_init(&root, json, (cj5_int)strlen(json));
+    CHECK(cj5_cursor_type(&root) == CJ5_TOKEN_OBJECT);
+
+    c = root;
+    CHECK(cj5_cursor_seek(&c, "window") && cj5_cursor_type(&c) == CJ5_TOKEN_OBJECT);
+    cj5_cursor window = c;
+    CHECK(cj5_cursor_seek(&c, "width") && cj5_cursor_get_int(&c, 0) == 800);
+    CHECK(cj5_cursor_get_double(&c, 0) == 800.0 && cj5_cursor_get_bool(&c, true));
+    c = window;
+    CHECK(cj5_cursor_seek(&c, "title"));
+    CHECK(strcmp(cj5_cursor_get_string(&c, str, 8, ""), "a\nb") == 0);
+    CHECK(cj5_cursor_get_int(&c, -5) == -5);
+    c = window;
+    CHECK(!cj5_cursor_seek(&c, "height") && c.pos == window.pos && c.error == CJ5_ERROR_NONE);
+
+    // the invalid array in "skip" is never read
+    c = root;
+    CHECK(cj5_cursor_seek(&c, "last") && cj5_cursor_get_uint(&c, 0) == 16);
+    CHECK(c.error == CJ5_ERROR_NONE);
+
+    c = root;
+    CHECK(cj5_cursor_seek(&c, "list"));
+    cj5_cursor list = c;
+    CHECK(cj5_cursor_elem(&c, 2) && cj5_cursor_type(&c) == CJ5_TOKEN_ARRAY);
+    c = list;
+    CHECK(cj5_cursor_elem(&c, 4) && cj5_cursor_get_bool(&c, false));
+    c = list;
+    CHECK(!cj5_cursor_elem(&c, 5) && c.pos == list.pos);
+    c = list;
+    int count = 0;
+    if (cj5_cursor_enter(&c)) {
+        do {
+            count++;
+        } while (cj5_cursor_next(&c));
+    }
+    CHECK(count == 5 && c.error == CJ5_ERROR_NONE);
+
+    // the value as tokens, positions are relative to it
+    c = window;
+    cj5_result r = cj5_cursor_parse(&c, tokens, MAX_TOKENS);
+    CHECK(r.error == CJ5_ERROR_NONE && r.num_tokens == 5 && r.json5 == &json[window.pos]);
+    CHECK(r.error == CJ5_ERROR_NONE && cj5_get_int(&r, cj5_seek(&r, 0, "width")) == 800);
+
+    // reading the invalid value stops the cursor
+    c = root;
+    CHECK(cj5_cursor_seek(&c, "skip") && cj5_cursor_seek(&c, "b") && cj5_cursor_elem(&c, 1));
+    CHECK(cj5_cursor_get_int(&c, -1) == -1 && c.error == CJ5_ERROR_INVALID);
+    CHECK(!cj5_cursor_seek(&c, "a"));
+}
+
+// saved tokens load back for the same document only, in both layouts
+static void check_token_cache(void)
+{
+    static cj5_token tokens[MAX_TOKENS];
+    static uint64_t blob[MAX_TOKENS * sizeof(cj5_token) / 8 + 64];
+    static char changed[1024];
+    for (int d = 0; d < NUM_DOCS; d++) {
+        const char* json = g_docs[d];
+        cj5_int len = (cj5_int)strlen(json);
+        cj5_result r = parse(json, tokens);
+        if (r.error != CJ5_ERROR_NONE) {
+            check(cj5_save_tokens(&r, len, blob, (cj5_int)sizeof(blob)) == -1, "cj5_save_tokens",
+                  d, 0);
+            continue;
+        }
+
+        for (int compact = 0; compact < 2; compact++) {
+            if (compact) {
+                cj5_compact(&r, tokens, cj5_compact(&r, NULL, 0));
+            }
+            cj5_int size = cj5_save_tokens(&r, len, NULL, 0);
+            bool ok = size > 0 && size <= (cj5_int)sizeof(blob) &&
+                      cj5_save_tokens(&r, len, blob, size - 1) == size &&
+                      cj5_save_tokens(&r, len, blob, size) == size;
+
+            cj5_result loaded = cj5_load_tokens(blob, size, json, len, true);
+            ok &= loaded.error == CJ5_ERROR_NONE && loaded.num_tokens == r.num_tokens &&
+                  (loaded.compact != NULL) == (compact != 0);
+            for (cj5_int i = 0; ok && i < r.num_tokens; i++) {
+                cj5_token a = cj5_get_token(&r, i);
+                cj5_token b = cj5_get_token(&loaded, i);
+                ok &= a.type == b.type && a.start == b.start && a.end == b.end &&
+                      a.size == b.size && a.parent_id == b.parent_id && a.next_id == b.next_id;
+            }
+            check(ok, compact ? "cj5_load_tokens compact" : "cj5_load_tokens", d, 0);
+
+            // same length, other content: only found with `verify`
+            memcpy(changed, json, (size_t)len);
+            changed[len - 1] = changed[len - 1] == ' ' ? '\t' : ' ';
+            check(cj5_load_tokens(blob, size, changed, len, true).error == CJ5_ERROR_CACHE &&
+                      cj5_load_tokens(blob, size, changed, len, false).error == CJ5_ERROR_NONE,
+                  "cj5_load_tokens changed", d, 0);
+            check(cj5_load_tokens(blob, size, json, len - 1, false).error == CJ5_ERROR_CACHE &&
+                      cj5_load_tokens(blob, size - 8, json, len, false).error == CJ5_ERROR_CACHE,
+                  "cj5_load_tokens size", d, 0);
+
+            // damaged tokens
+            ((uint8_t*)blob)[size - 1] ^= 0x10;
+            check(cj5_load_tokens(blob, size, json, len, true).error == CJ5_ERROR_CACHE,
+                  "cj5_load_tokens damaged", d, 0);
+        }
+    }
+}
+
+int main(void)
+{
+    check_docs();
+    check_doubles();
+    check_writer_size();
+    check_write_token();
+    check_write_doubles();
+    check_array_numbers();
+    check_integers();
+    check_strings();
+    check_index();
+    check_records();
+#if CJ5_MMAP
+    check_file();
+#endif
+    check_compact();
+    check_paths();
+    check_bind();
+    check_cursor();
+    check_token_cache();
+
+    printf("%d checks, %d failed\n", g_num_checks, g_num_failed);
+    return g_num_failed ? 1 : 0;
+}
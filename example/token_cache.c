@@ -0,0 +1,78 @@
+// loads the tokens of a document from a cache file next to it, or parses it and writes the cache
+// (see `cj5_save_tokens`). run it twice on the same file to see the difference
+// build: cc -O2 token_cache.c -o token_cache -lm
+// usage: token_cache <file.json5>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define CJ5_IMPLEMENT
+#include "../cj5.h"
+
+static double elapsed(clock_t start)
+{
+    return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        printf("usage: token_cache <file.json5>\n");
+        return 1;
+    }
+
+    char cache_path[1024];
+    snprintf(cache_path, sizeof(cache_path), "%s.cj5t", argv[1]);
+
+    cj5_file doc;
+    if (!cj5_file_open(&doc, argv[1])) {
+        printf("ERROR: can't open %s\n", argv[1]);
+        return 1;
+    }
+
+    // the blob is used in place, the result points into the mapping
+    clock_t start = clock();
+    cj5_file cache;
+    if (cj5_file_open(&cache, cache_path)) {
+        cj5_result r = cj5_load_tokens(cache.data, cache.size, doc.data, doc.size, true);
+        if (r.error == CJ5_ERROR_NONE) {
+            printf("loaded %d tokens from %s: %.4f s\n", (int)r.num_tokens, cache_path,
+                   elapsed(start));
+            cj5_file_close(&cache);
+            cj5_file_close(&doc);
+            return 0;
+        }
+        printf("%s is out of date\n", cache_path);
+        cj5_file_close(&cache);
+    }
+
+    start = clock();
+    cj5_result r = cj5_parse(doc.data, doc.size, NULL, 0);
+    cj5_int num_tokens = r.num_tokens;
+    cj5_token* tokens = (cj5_token*)malloc(sizeof(cj5_token) * (size_t)num_tokens);
+    r = cj5_parse(doc.data, doc.size, tokens, num_tokens);
+    if (r.error) {
+        printf("ERROR: %d, line: %d, col: %d\n", r.error, (int)r.error_line, (int)r.error_col);
+        return 1;
+    }
+    printf("parsed %d tokens: %.4f s\n", (int)num_tokens, elapsed(start));
+
+    // the compact layout makes the cache smaller, and it can be loaded with or without CJ5_LARGE
+    cj5_compact(&r, tokens, (cj5_int)sizeof(cj5_token) * num_tokens);
+    cj5_int size = cj5_save_tokens(&r, doc.size, NULL, 0);
+    void* blob = malloc((size_t)size);
+    cj5_save_tokens(&r, doc.size, blob, size);
+
+    FILE* f = fopen(cache_path, "wb");
+    if (!f || fwrite(blob, 1, (size_t)size, f) != (size_t)size) {
+        printf("ERROR: can't write %s\n", cache_path);
+        return 1;
+    }
+    fclose(f);
+    printf("saved %s: %d bytes\n", cache_path, (int)size);
+
+    free(blob);
+    free(tokens);
+    cj5_file_close(&doc);
+    return 0;
+}